@@ -0,0 +1,122 @@
+#include "bench.h"
+#include "math-dsp.h"
+#include "phase-warp.h"
+#include <vector>
+#include <functional>
+#include <cstdio>
+#include <cmath>
+
+// the editor operations as they were, scalar and allocating
+static void smooth_reference(std::vector<double> &data, double s) {
+  const unsigned n = data.size();
+  for (unsigned i = 0; i < n; ++i) {
+    double input = data[i];
+    double nextinput = (i + 1 < n) ? data[i + 1] : input;
+    data[i] = nextinput * (1.0 - s) + input * s;
+  }
+}
+
+static void window_reference(std::vector<double> &data, double a) {
+  const unsigned n = data.size();
+  for (unsigned i = 0; i < n; ++i)
+    data[i] *= tukey_window(a, double(i) / (n - 1));
+}
+
+static void shift_reference(std::vector<double> &data, int off) {
+  const int n = data.size();
+  std::vector<double> newdata(n);
+  for (int x = 0; x < n; ++x) {
+    int newx = x - off;
+    newdata[x] = (newx < 0) ? data[0] : (newx >= n) ? data[n - 1] : data[newx];
+  }
+  std::copy(newdata.begin(), newdata.end(), data.begin());
+}
+
+static void mirror_reference(std::vector<double> &data) {
+  const unsigned n = data.size();
+  for (unsigned i = 0; i < n / 2; ++i)
+    data[n - i - 1] = data[i];
+}
+
+static void negate_reference(std::vector<double> &data) {
+  for (double &x : data)
+    x = -x;
+}
+
+static void warp_reference(std::vector<double> &data, double amount) {
+  const unsigned n = data.size();
+  std::vector<double> out(n);
+  for (unsigned i = 0; i < n; ++i) {
+    double position = warp_phase(double(i) / n, amount) * n;
+    unsigned index = unsigned(position);
+    double frac = position - index;
+    if (index >= n) {
+      index = 0;
+      frac = 0;
+    }
+    double x0 = data[index];
+    double x1 = data[(index + 1 < n) ? index + 1 : 0];
+    out[i] = x0 + frac * (x1 - x0);
+  }
+  data = out;
+}
+
+void bench_editor() {
+  const unsigned repeat = 100;
+
+  std::printf("%8s %-8s %14s %14s %8s %12s\n", "size", "op",
+              "before us", "after us", "speedup", "max diff");
+  for (unsigned size : {1024u, 65536u}) {
+    std::vector<double> source(size);
+    for (unsigned i = 0; i < size; ++i)
+      source[i] = std::sin(2 * M_PI * i / size) + 0.1 * std::sin(2 * M_PI * 37 * i / size);
+
+    struct Op {
+      const char *name;
+      std::function<void(std::vector<double> &)> before, after;
+    };
+    TukeyWindow window(0.5, size);
+    PhaseWarp warp(0.6, size);
+    std::vector<double> unwarped(size);
+    const Op ops[] = {
+      {"smooth", [](std::vector<double> &d) { smooth_reference(d, 0.3); },
+                 [](std::vector<double> &d) { smooth_samples(d.data(), d.size(), 0.3); }},
+      {"window", [](std::vector<double> &d) { window_reference(d, 0.5); },
+                 [&](std::vector<double> &d) { window.apply(d.data()); }},
+      {"shift", [](std::vector<double> &d) { shift_reference(d, 5); },
+                [](std::vector<double> &d) { shift_samples(d.data(), d.size(), 5); }},
+      {"mirror", [](std::vector<double> &d) { mirror_reference(d); },
+                 [](std::vector<double> &d) { mirror_samples(d.data(), d.size(), true); }},
+      {"invert", [](std::vector<double> &d) { negate_reference(d); },
+                 [](std::vector<double> &d) { negate_samples(d.data(), d.size()); }},
+      {"warp", [](std::vector<double> &d) { warp_reference(d, 0.6); },
+               [&](std::vector<double> &d) {
+                 std::copy(d.begin(), d.end(), unwarped.begin());
+                 warp.apply(unwarped.data(), d.data()); }},
+    };
+
+    for (const Op &op : ops) {
+      std::vector<double> d1 = source, d2 = source;
+      double t1 = bench_time([&]() {
+        for (unsigned r = 0; r < repeat; ++r)
+          op.before(d1);
+      });
+      double t2 = bench_time([&]() {
+        for (unsigned r = 0; r < repeat; ++r)
+          op.after(d2);
+      });
+
+      // once on the same data, for the difference of results
+      d1 = source;
+      d2 = source;
+      op.before(d1);
+      op.after(d2);
+      double diff = 0;
+      for (unsigned i = 0; i < size; ++i)
+        diff = std::fmax(diff, std::fabs(d1[i] - d2[i]));
+
+      std::printf("%8u %-8s %14.2f %14.2f %8.1f %12g\n", size, op.name,
+                  1e6 * t1 / repeat, 1e6 * t2 / repeat, t1 / t2, diff);
+    }
+  }
+}
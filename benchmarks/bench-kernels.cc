@@ -0,0 +1,104 @@
+#include "bench.h"
+#include "math-dsp-kernels.h"
+#include <vector>
+#include <functional>
+#include <cstdio>
+#include <algorithm>
+#include <cmath>
+
+// each path of the sample kernels against the generic one
+void bench_kernels() {
+  const unsigned size = 65536;
+  const unsigned repeat = 20;
+
+  std::vector<double> source(size), factors(size);
+  std::vector<float> fsource(size), isource(size);
+  for (unsigned i = 0; i < size; ++i) {
+    source[i] = std::sin(2 * M_PI * i / size) + 0.1 * std::sin(2 * M_PI * 37 * i / size);
+    factors[i] = 0.5 + 0.5 * std::cos(2 * M_PI * i / size);
+    fsource[i] = 1.5f * float(source[i]);
+    isource[i] = std::round(20000.0f * float(source[i]));
+  }
+  std::vector<int32_t> index(size), next(size);
+  for (unsigned i = 0; i < size; ++i) {
+    index[i] = (i * 7919u) % size;
+    next[i] = (index[i] + 1) % size;
+  }
+  std::vector<double> warped(size);
+  // the special values the conversions must agree on
+  fsource[1] = INFINITY;
+  fsource[2] = -INFINITY;
+  fsource[3] = NAN;
+  fsource[4] = 0.5f / 32767;
+  fsource[5] = -0.5f / 32767;
+
+  struct Op {
+    const char *name;
+    std::function<void(const SampleKernels &, std::vector<double> &, std::vector<float> &)> run;
+    bool floats;
+  };
+  const Op ops[] = {
+    {"smooth", [](const SampleKernels &k, std::vector<double> &d, std::vector<float> &) {
+        k.smooth(d.data(), d.size(), 0.3); }, false},
+    {"negate", [](const SampleKernels &k, std::vector<double> &d, std::vector<float> &) {
+        k.negate(d.data(), d.size()); }, false},
+    {"multiply", [&](const SampleKernels &k, std::vector<double> &d, std::vector<float> &) {
+        k.multiply(d.data(), factors.data(), d.size()); }, false},
+    {"mirror", [](const SampleKernels &k, std::vector<double> &d, std::vector<float> &) {
+        k.mirror(d.data(), d.size(), true); }, false},
+    {"warp", [&](const SampleKernels &k, std::vector<double> &d, std::vector<float> &) {
+        k.warp(source.data(), index.data(), next.data(), factors.data(), warped.data(), size);
+        std::copy(warped.begin(), warped.end(), d.begin()); }, false},
+    {"interpolate", [&](const SampleKernels &k, std::vector<double> &, std::vector<float> &f) {
+        k.interpolate(fsource.data(), 1000, f.data(), f.size()); }, true},
+    {"normalize", [](const SampleKernels &k, std::vector<double> &, std::vector<float> &f) {
+        k.normalize(f.data(), f.size(), 32767.0f); }, true},
+    {"quantize", [](const SampleKernels &k, std::vector<double> &, std::vector<float> &f) {
+        k.quantize(f.data(), f.size(), 32767.0f); }, true},
+    {"scan", [&](const SampleKernels &k, std::vector<double> &, std::vector<float> &f) {
+        SampleScan scan {isource[0], isource[0], true};
+        k.scan(isource.data(), isource.size(), scan);
+        f[0] = scan.min;
+        f[1] = scan.max;
+        f[2] = scan.integral; }, true},
+  };
+
+  const SampleKernels generic = sample_kernels_generic();
+  std::printf("%-12s %-8s %12s %8s %12s\n", "op", "path", "time us", "speedup", "max diff");
+  for (const Op &op : ops) {
+    std::vector<double> dref = source;
+    std::vector<float> fref = fsource;
+    double tref = bench_time([&]() {
+      for (unsigned r = 0; r < repeat; ++r) {
+        std::vector<float> &f = fref;
+        op.run(generic, dref, f);
+      }
+    });
+
+    for (unsigned p = 0; p <= cpu_path(); ++p) {
+      const SampleKernels kernels = sample_kernels_for(CpuPath(p));
+      std::vector<double> d = source;
+      std::vector<float> f = fsource;
+      double t = bench_time([&]() {
+        for (unsigned r = 0; r < repeat; ++r)
+          op.run(kernels, d, f);
+      });
+
+      // once from the same data, for the difference of results
+      dref = d = source;
+      fref = f = fsource;
+      op.run(generic, dref, fref);
+      op.run(kernels, d, f);
+      double diff = 0;
+      for (unsigned i = 0; i < size; ++i) {
+        double x = op.floats ? fref[i] : dref[i];
+        double y = op.floats ? f[i] : d[i];
+        if (!(x == y || (x != x && y != y)))
+          diff = std::fmax(diff, std::isnan(x - y) ? INFINITY : std::fabs(x - y));
+      }
+
+      std::printf("%-12s %-8s %12.2f %8.2f %12g\n", op.name, cpu_path_name(CpuPath(p)),
+                  1e6 * t / repeat, tref / t, diff);
+    }
+  }
+}
@@ -0,0 +1,171 @@
+#include "bench.h"
+#include "math-dsp.h"
+#include <speex/speex_resampler.h>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <cmath>
+
+// resampling as before the cache of states, a new state every call
+static void resample_uncached(const float *in_samples,
+                              unsigned in_sample_count,
+                              float *out_samples,
+                              unsigned out_sample_count) {
+  int err {};
+  SpeexResamplerState *resampler = speex_resampler_init(
+    1, in_sample_count, out_sample_count, SPEEX_RESAMPLER_QUALITY_MAX, &err);
+  speex_resampler_skip_zeros(resampler);
+
+  while (out_sample_count > 0) {
+    unsigned in_count = in_sample_count;
+    unsigned out_count = out_sample_count;
+    speex_resampler_process_float(
+      resampler, 0, in_samples, &in_count, out_samples, &out_count);
+    in_samples += in_count;
+    in_sample_count -= in_count;
+    out_samples += out_count;
+    out_sample_count -= out_count;
+    if (out_count == 0)
+      break;
+  }
+
+  static const float zero[32] {};
+  while (out_sample_count > 0) {
+    unsigned in_count = 32;
+    unsigned out_count = out_sample_count;
+    speex_resampler_process_float(
+      resampler, 0, zero, &in_count, out_samples, &out_count);
+    out_samples += out_count;
+    out_sample_count -= out_count;
+  }
+
+  speex_resampler_destroy(resampler);
+}
+
+void bench_resample() {
+  struct Ratio { unsigned in, out; };
+  const Ratio ratios[] = {
+    {1024, 1024}, {600, 1024}, {1024, 600}, {2048, 1024}, {4096, 256}, {1000, 1021},
+  };
+  const unsigned calls = 20;
+
+  std::printf("%6s %6s %14s %14s %8s %12s %14s\n", "in", "out",
+              "uncached us", "cached us", "speedup", "max diff", "periodic us");
+  for (const Ratio &r : ratios) {
+    std::vector<float> in(r.in), out1(r.out), out2(r.out);
+    for (unsigned i = 0; i < r.in; ++i)
+      in[i] = std::sin(2 * M_PI * 3 * i / r.in) + 0.25 * std::sin(2 * M_PI * 17 * i / r.in);
+
+    double t1 = bench_time([&]() {
+      for (unsigned c = 0; c < calls; ++c)
+        resample_uncached(in.data(), r.in, out1.data(), r.out);
+    });
+    double t2 = bench_time([&]() {
+      for (unsigned c = 0; c < calls; ++c)
+        resample(in.data(), r.in, out2.data(), r.out, ResampleSpeexBest);
+    });
+
+    double t3 = bench_time([&]() {
+      for (unsigned c = 0; c < calls; ++c)
+        resample_periodic(in.data(), r.in, out2.data(), r.out);
+    });
+    resample(in.data(), r.in, out2.data(), r.out, ResampleSpeexBest);
+
+    // a reused state must give the output of a new one
+    double diff = 0;
+    for (unsigned i = 0; i < r.out; ++i)
+      diff = std::fmax(diff, std::fabs(out1[i] - out2[i]));
+
+    std::printf("%6u %6u %14.1f %14.1f %8.1f %12g %14.1f\n", r.in, r.out,
+                1e6 * t1 / calls, 1e6 * t2 / calls, t1 / t2, diff, 1e6 * t3 / calls);
+  }
+}
+
+// a period with harmonics 1 to `harmonics`, falling as 1/k
+static double band_limited(double x, unsigned harmonics) {
+  double s = 0;
+  for (unsigned k = 1; k <= harmonics; ++k)
+    s += std::sin(2 * M_PI * k * x + 0.5 * k) / k;
+  return 0.5 * s;
+}
+
+void bench_resample_quality() {
+  struct Ratio { unsigned in, out; };
+  const Ratio ratios[] = {{600, 1024}, {1024, 2048}, {2048, 1024}, {4096, 1000}};
+  const unsigned calls = 20;
+  static const char *quality_names[] = RESAMPLE_QUALITY_NAMES;
+
+  // the errors from the exact resampling of a band-limited period
+  std::printf("%6s %6s %-14s %10s %12s %12s\n", "in", "out", "quality",
+              "us", "max error", "rms error");
+  for (const Ratio &r : ratios) {
+    const unsigned harmonics = std::min(r.in, r.out) * 2 / 5;
+    std::vector<float> in(r.in), out(r.out);
+    for (unsigned i = 0; i < r.in; ++i)
+      in[i] = band_limited(double(i) / r.in, harmonics);
+
+    for (int q = ResampleLinear; q <= ResamplePeriodic; ++q) {
+      ResampleQuality quality = ResampleQuality(q);
+      double t = bench_time([&]() {
+        for (unsigned c = 0; c < calls; ++c)
+          resample(in.data(), r.in, out.data(), r.out, quality);
+      });
+
+      double max = 0, sum = 0;
+      for (unsigned i = 0; i < r.out; ++i) {
+        double e = out[i] - band_limited(double(i) / r.out, harmonics);
+        max = std::fmax(max, std::fabs(e));
+        sum += e * e;
+      }
+
+      std::printf("%6u %6u %-14s %10.1f %12.2e %12.2e\n", r.in, r.out,
+                  quality_names[q], 1e6 * t / calls, max, std::sqrt(sum / r.out));
+    }
+  }
+}
+
+void bench_resample_batch() {
+  const unsigned tables = 256;
+  const unsigned in_size = 2048;
+  const unsigned out_size = 1000;
+
+  std::vector<std::vector<float>> in(tables, std::vector<float>(in_size));
+  std::vector<std::vector<float>> out(tables, std::vector<float>(out_size));
+  std::vector<float> expected(out_size);
+  std::vector<const float *> in_tables;
+  std::vector<float *> out_tables;
+  for (unsigned t = 0; t < tables; ++t) {
+    for (unsigned i = 0; i < in_size; ++i)
+      in[t][i] = std::sin(2 * M_PI * (1 + t % 13) * i / in_size);
+    in_tables.push_back(in[t].data());
+    out_tables.push_back(out[t].data());
+  }
+
+  const ResampleQuality qualities[] = {ResamplePeriodic, ResampleSpeexBest};
+  const char *names[] = RESAMPLE_QUALITY_NAMES;
+
+  std::printf("%u tables, %u to %u samples\n", tables, in_size, out_size);
+  std::printf("%12s %6s %12s %8s %12s\n", "quality", "jobs", "time ms", "speedup", "max diff");
+  for (ResampleQuality quality : qualities) {
+    double t1 = 0;
+    for (unsigned jobs : {1u, 2u, 4u, 8u, 16u}) {
+      double t = bench_time([&]() {
+        resample_batch(in_tables.data(), in_size, out_tables.data(), out_size,
+                       tables, quality, jobs);
+      });
+      if (jobs == 1)
+        t1 = t;
+
+      // the same as one table at a time
+      double diff = 0;
+      for (unsigned n = 0; n < tables; ++n) {
+        resample(in[n].data(), in_size, expected.data(), out_size, quality);
+        for (unsigned i = 0; i < out_size; ++i)
+          diff = std::fmax(diff, std::fabs(expected[i] - out[n][i]));
+      }
+
+      std::printf("%12s %6u %12.2f %8.2f %12g\n", names[quality], jobs,
+                  1e3 * t, t1 / t, diff);
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#include "bench.h"
+#include "harmonic-spectrum.h"
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+void bench_spectrum() {
+  const unsigned size = 4096;
+  const unsigned harmonics = 64;
+  const unsigned strokes = 1000;
+
+  std::vector<double> data(size);
+  for (unsigned i = 0; i < size; ++i)
+    data[i] = std::sin(2 * M_PI * i / size);
+
+  std::printf("%8s %10s %10s %16s %16s %12s\n", "size", "harmonics", "stroke",
+              "incremental us", "transform us", "drift");
+  for (unsigned stroke : {1u, 8u, 32u, 128u}) {
+    HarmonicSpectrum incremental(harmonics);
+    HarmonicSpectrum full(harmonics);
+    incremental.reset(data.data(), size);
+
+    // strokes across the table, as mouse moves would draw
+    std::vector<double> drawn = data;
+    unsigned seed = 1;
+    auto draw = [&](std::vector<double> &d, HarmonicSpectrum *s) {
+      seed = seed * 1103515245 + 12345;
+      unsigned start = (seed >> 8) % (size - stroke);
+      double level = double((seed >> 4) % 1000) / 500.0 - 1.0;
+      for (unsigned i = start; i < start + stroke; ++i) {
+        if (s)
+          s->update(i, d[i], level);
+        d[i] = level;
+      }
+    };
+
+    double t1 = bench_time([&]() {
+      for (unsigned n = 0; n < strokes; ++n)
+        draw(drawn, &incremental);
+    }, 1);
+
+    std::vector<double> drawn2 = data;
+    seed = 1;
+    double t2 = bench_time([&]() {
+      for (unsigned n = 0; n < strokes; ++n) {
+        draw(drawn2, nullptr);
+        full.reset(drawn2.data(), size);
+      }
+    }, 1);
+
+    // the error the updates accumulate, against a new transform
+    full.reset(drawn.data(), size);
+    double drift = 0;
+    for (unsigned k = 0; k <= harmonics; ++k)
+      drift = std::fmax(drift, std::abs(incremental.bin(k) - full.bin(k)) / size);
+
+    std::printf("%8u %10u %10u %16.2f %16.2f %12.2e\n", size, harmonics, stroke,
+                1e6 * t1 / strokes, 1e6 * t2 / strokes, drift);
+  }
+
+  // a table rebuilt from its harmonics, as each stroke of the harmonic editor
+  std::printf("\n%8s %10s %16s\n", "size", "harmonics", "synthesis us");
+  for (unsigned tablesize : {1024u, 4096u}) {
+    const unsigned count = 256;
+    std::vector<double> amps(count), phases(count), table(tablesize);
+    for (unsigned k = 0; k < count; ++k) {
+      amps[k] = 1.0 / (k + 1);
+      phases[k] = 0.1 * k;
+    }
+    const unsigned runs = 1000;
+    double t = bench_time([&]() {
+      for (unsigned n = 0; n < runs; ++n)
+        synthesize_harmonics(0.0, amps.data(), phases.data(), count, table.data(), tablesize);
+    }, 1);
+    std::printf("%8u %10u %16.2f\n", tablesize, count, 1e6 * t / runs);
+  }
+}
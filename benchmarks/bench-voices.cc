@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "voice-engine.h"
+#include "wave-table.h"
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+void bench_voices() {
+  const double sample_rate = 48000;
+  const unsigned seconds = 2;
+  const unsigned blocks = seconds * sample_rate / VoiceEngine::blockSize;
+
+  std::vector<double> saw(2048);
+  for (unsigned i = 0; i < saw.size(); ++i)
+    saw[i] = 1.0 - 2.0 * i / saw.size();
+  MipmapWavetable table(saw.data(), saw.size());
+
+  static const char *quality_names[] = INTERPOLATION_QUALITY_NAMES;
+  std::vector<float> block(VoiceEngine::blockSize);
+
+  std::printf("%-8s %6s %12s %10s\n", "quality", "voices", "ns/sample", "cpu %");
+  for (int quality : {InterpLinear, InterpHermite, InterpSinc}) {
+    for (unsigned count : {1u, 16u, 64u, 128u}) {
+      VoiceEngine engine(count);
+      engine.setSampleRate(sample_rate);
+      for (unsigned v = 0; v < count; ++v)
+        engine.noteOn(v, 55.0 * std::exp2(v / 12.0 * 0.5));
+
+      double t = bench_time([&]() {
+        for (unsigned b = 0; b < blocks; ++b)
+          engine.renderBlock(&table, InterpolationQuality(quality), 0.0, block.data());
+      });
+
+      double frames = double(blocks) * VoiceEngine::blockSize;
+      std::printf("%-8s %6u %12.2f %10.2f\n", quality_names[quality], count,
+                  1e9 * t / (frames * count), 100.0 * t / seconds);
+    }
+  }
+}
+
+void bench_morph() {
+  const double sample_rate = 48000;
+  const unsigned seconds = 2;
+  const unsigned blocks = seconds * sample_rate / VoiceEngine::blockSize;
+  const unsigned voices = 64;
+  const unsigned size = 2048;
+  const unsigned frames = 256;
+
+  // frames of a saw, more and more pulse-like
+  std::vector<double> bank(size * frames);
+  for (unsigned f = 0; f < frames; ++f) {
+    for (unsigned i = 0; i < size; ++i) {
+      double x = double(i) / size;
+      double duty = 0.5 + 0.45 * f / frames;
+      bank[f * size + i] = (1.0 - 2.0 * x) + ((x < duty) ? 0.5 : -0.5);
+    }
+  }
+
+  double t1 = bench_time([&]() { MipmapWavetable(bank.data(), size, frames); }, 1);
+  std::printf("building %u x %u: %.1f ms\n", frames, size, 1e3 * t1);
+
+  MipmapWavetable single(bank.data(), size, 1);
+  MipmapWavetable multi(bank.data(), size, frames);
+
+  static const char *quality_names[] = INTERPOLATION_QUALITY_NAMES;
+  std::vector<float> block(VoiceEngine::blockSize);
+
+  std::printf("%-8s %6s %14s %14s %8s\n", "quality", "voices",
+              "single ns/smp", "morph ns/smp", "ratio");
+  for (int quality : {InterpLinear, InterpHermite, InterpSinc}) {
+    double t[2];
+    for (unsigned m = 0; m < 2; ++m) {
+      const MipmapWavetable &table = m ? multi : single;
+      VoiceEngine engine(voices);
+      engine.setSampleRate(sample_rate);
+      for (unsigned v = 0; v < voices; ++v)
+        engine.noteOn(v, 55.0 * std::exp2(v / 12.0 * 0.5));
+
+      // sweep the morph position across the frames, back and forth
+      t[m] = bench_time([&]() {
+        for (unsigned b = 0; b < blocks; ++b) {
+          double x = std::fabs(std::fmod(4.0 * b / blocks, 2.0) - 1.0);
+          engine.renderBlock(&table, InterpolationQuality(quality),
+                             x * (frames - 1), block.data());
+        }
+      });
+    }
+
+    double samples = double(blocks) * VoiceEngine::blockSize * voices;
+    std::printf("%-8s %6u %14.2f %14.2f %8.2f\n", quality_names[quality], voices,
+                1e9 * t[0] / samples, 1e9 * t[1] / samples, t[1] / t[0]);
+  }
+}
@@ -0,0 +1,190 @@
+#include "bench.h"
+#include "wave-io.h"
+#include <boost/algorithm/string.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+// the array reader as it was, scanf for each sample from its position
+static bool read_array_reference(const std::string &in, std::vector<float> &samples) {
+  size_t index = in.find('{');
+  if (index == std::string::npos)
+    return false;
+  ++index;
+  samples.clear();
+  while (index < in.size() && in[index] != '}') {
+    float num {};
+    int nscanf {};
+    if (sscanf(in.c_str() + index, "%f%n", &num, &nscanf) != 1)
+      return false;
+    index += nscanf;
+    samples.push_back(num);
+    if (index < in.size() && in[index] == ',')
+      ++index;
+    while (index < in.size() && (in[index] == ' ' || in[index] == '\n'))
+      ++index;
+  }
+  return true;
+}
+
+// the column reader as it was, a stream for each line
+static void read_column_reference(const std::string &in_, unsigned channel, std::vector<float> &samples) {
+  std::istringstream in(in_, std::ios::binary);
+  std::string line;
+  std::vector<float> row;
+  samples.clear();
+  do {
+    line.clear();
+    std::getline(in, line);
+    size_t commentpos = line.rfind('#');
+    if (commentpos != line.npos)
+      line.resize(commentpos);
+    boost::trim_if(line, boost::is_any_of("\t "));
+    if (!line.empty()) {
+      float sample;
+      row.clear();
+      for (std::istringstream linestream(line, std::ios::binary); linestream >> sample;)
+        row.push_back(sample);
+    }
+    samples.push_back((channel < row.size()) ? row[channel] : 0.0f);
+  } while (in);
+}
+
+static std::string make_header(unsigned arrays, unsigned size, bool literals) {
+  std::string text = "// generated\n";
+  char buf[64];
+  for (unsigned a = 0; a < arrays; ++a) {
+    text += "static const float wave" + std::to_string(a) + "[] = {\n";
+    for (unsigned i = 0; i < size; ++i) {
+      float x = float(std::sin(2 * M_PI * (a + 1) * i / size));
+      std::snprintf(buf, sizeof(buf), literals ? "%.9gf," : "%.9g,", x);
+      text += buf;
+      text += ((i + 1) % 8) ? ' ' : '\n';
+    }
+    text += "};\n";
+  }
+  return text;
+}
+
+static std::string make_columns(unsigned rows, unsigned columns) {
+  std::string text = "# generated\n";
+  char buf[64];
+  for (unsigned i = 0; i < rows; ++i) {
+    for (unsigned c = 0; c < columns; ++c) {
+      float x = float(std::sin(2 * M_PI * (c + 1) * i / rows));
+      std::snprintf(buf, sizeof(buf), c ? "\t%.9g" : "%.9g", x);
+      text += buf;
+    }
+    text += '\n';
+  }
+  return text;
+}
+
+void bench_parse() {
+  const unsigned size = 2048;
+
+  // the channel read is the last one, so every array is parsed
+  std::printf("%8s %12s %12s %12s\n", "arrays", "MB", "ms", "MB/s");
+  for (unsigned arrays : {16u, 256u}) {
+    std::string text = make_header(arrays, size, true);
+    std::vector<float> out(size);
+    bool ok = true;
+    double t = bench_time([&] {
+      ok = read_wave_from_string(out.data(), size, text, WaveCpp, arrays - 1, ResampleLinear) && ok;
+    });
+    double mb = text.size() / 1e6;
+    std::printf("%8u %12.2f %12.2f %12.1f%s\n", arrays, mb, t * 1e3, mb / t, ok ? "" : " (failed)");
+  }
+
+  // against scanf, which is quadratic as it measures the rest of the text
+  std::printf("\n%8s %14s %14s %8s %12s\n", "samples", "before us", "after us", "speedup", "max diff");
+  for (unsigned count : {256u, 2048u, 16384u}) {
+    std::string text = make_header(1, count, false);
+    std::vector<float> before, after(count);
+    double t1 = bench_time([&] { read_array_reference(text, before); });
+    double t2 = bench_time([&] {
+      read_wave_from_string(after.data(), count, text, WaveCpp, 0, ResampleLinear);
+    });
+    double diff = (before.size() == count) ? 0 : INFINITY;
+    for (unsigned i = 0; i < count && diff == 0; ++i)
+      diff = std::fabs(before[i] - after[i]);
+    std::printf("%8u %14.1f %14.1f %8.1f %12g\n", count, t1 * 1e6, t2 * 1e6, t1 / t2, diff);
+  }
+
+  // data points, 4 columns of which the third is read
+  std::printf("\n%8s %12s %14s %14s %8s %12s\n", "rows", "MB", "before ms", "after ms", "speedup", "max diff");
+  for (unsigned rows : {4096u, 1u << 20}) {
+    std::string text = make_columns(rows, 4);
+    std::vector<float> before, after;
+    double t1 = bench_time([&] { read_column_reference(text, 2, before); }, 3);
+    // a sample a line, read at its own length
+    after.resize(before.size());
+    double t2 = bench_time([&] {
+      read_wave_from_string(after.data(), after.size(), text, WaveDat, 2, ResampleLinear);
+    }, 3);
+    double diff = 0;
+    for (size_t i = 0; i < before.size(); ++i)
+      diff = std::max<double>(diff, std::fabs(before[i] - after[i]));
+    std::printf("%8u %12.2f %14.2f %14.2f %8.1f %12g\n", rows, text.size() / 1e6,
+                t1 * 1e3, t2 * 1e3, t1 / t2, diff);
+  }
+
+  // a bank of 256 tables, of which the last is read, from text and RIFF
+  std::printf("\n%8s %-8s %12s %12s\n", "tables", "format", "MB", "ms");
+  {
+    const unsigned tables = 256;
+    std::vector<float> bank(tables * size);
+    for (unsigned i = 0; i < bank.size(); ++i)
+      bank[i] = float(std::sin(2 * M_PI * (i / size + 1) * (i % size) / size));
+    std::vector<float> out(size);
+    for (WaveFormat fmt : {WaveDat, WaveRiff}) {
+      std::ostringstream text;
+      write_wave(bank.data(), bank.size(), bank.size(), fmt, WaveFloat, text, ResampleLinear);
+      std::string data = text.str();
+      double t = bench_time([&] {
+        read_wave_from_string(out.data(), size, data, fmt, 0, ResampleLinear, size, tables - 1);
+      }, 3);
+      std::printf("%8u %-8s %12.2f %12.3f\n", tables, (fmt == WaveDat) ? "dat" : "wav",
+                  data.size() / 1e6, t * 1e3);
+    }
+  }
+}
+
+void bench_write() {
+  const unsigned size = 100000;
+  std::vector<float> samples(size);
+  for (unsigned i = 0; i < size; ++i)
+    samples[i] = float(0.8 * std::sin(2 * M_PI * 3 * i / size) + 0.1 * std::sin(2 * M_PI * 101 * i / size));
+
+  // the samples through operator<< as before, against write_wave
+  std::printf("%8s %-8s %14s %14s %8s %10s\n", "samples", "format", "before MB/s", "after MB/s", "speedup", "exact");
+  for (WaveFormat fmt : {WaveDat, WaveCpp}) {
+    std::string before, after;
+    double t1 = bench_time([&] {
+      std::ostringstream out;
+      for (unsigned i = 0; i < size; ++i) {
+        if (fmt == WaveDat)
+          out << samples[i] << '\n';
+        else
+          out << ' ' << samples[i] << ',';
+      }
+      before = out.str();
+    });
+    double t2 = bench_time([&] {
+      std::ostringstream out;
+      write_wave(samples.data(), size, size, fmt, WaveFloat, out, ResampleLinear);
+      after = out.str();
+    });
+
+    // bits read back, which 6 digits of precision lose
+    std::vector<float> back(size);
+    read_wave_from_string(back.data(), size, after, fmt, 0, ResampleLinear);
+    bool exact = back == samples;
+    std::printf("%8u %-8s %14.1f %14.1f %8.1f %10s\n", size, (fmt == WaveDat) ? "dat" : "cpp",
+                before.size() / t1 / 1e6, after.size() / t2 / 1e6, t1 / t2, exact ? "yes" : "no");
+  }
+}
@@ -0,0 +1,41 @@
+#include "bench.h"
+#include "cpu-dispatch.h"
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+struct Benchmark {
+  const char *name;
+  void (*fn)();
+};
+
+static const Benchmark benchmarks[] = {
+  {"voices", &bench_voices},
+  {"morph", &bench_morph},
+  {"resample", &bench_resample},
+  {"resample-quality", &bench_resample_quality},
+  {"resample-batch", &bench_resample_batch},
+  {"editor", &bench_editor},
+  {"kernels", &bench_kernels},
+  {"spectrum", &bench_spectrum},
+  {"parse", &bench_parse},
+  {"write", &bench_write},
+};
+
+int main(int argc, char *argv[]) {
+  const char *forced = getenv("DESSINER_CPU_PATH");
+  std::printf("kernels: %s%s%s\n", cpu_path_name(cpu_path()),
+              forced ? ", DESSINER_CPU_PATH=" : "", forced ? forced : "");
+
+  for (const Benchmark &b : benchmarks) {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc && !selected; ++i)
+      selected = !std::strcmp(argv[i], b.name);
+    if (!selected)
+      continue;
+    std::printf("\n== %s\n", b.name);
+    b.fn();
+  }
+
+  return 0;
+}
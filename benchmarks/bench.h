@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+
+// benchmarks of the DSP code, each printing a small report
+void bench_voices();
+void bench_morph();
+void bench_resample();
+void bench_resample_quality();
+void bench_resample_batch();
+void bench_editor();
+void bench_kernels();
+void bench_spectrum();
+void bench_parse();
+void bench_write();
+
+// seconds taken by a call of `fn`, best of `repeat`
+template <class Fn>
+double bench_time(Fn &&fn, unsigned repeat = 5) {
+  double best = 0;
+  for (unsigned r = 0; r < repeat; ++r) {
+    auto t1 = std::chrono::steady_clock::now();
+    fn();
+    auto t2 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double>(t2 - t1).count();
+    if (r == 0 || t < best)
+      best = t;
+  }
+  return best;
+}
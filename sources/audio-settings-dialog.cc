@@ -0,0 +1,82 @@
+#include "audio-settings-dialog.h"
+#include "main.h"
+#include <QVBoxLayout>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QLabel>
+#include <QDialogButtonBox>
+#include <QAudioFormat>
+
+struct AudioSettingsDialog::Impl {
+  QComboBox *selPeriod {};
+  QSpinBox *valPeriods {};
+  QLabel *lblLatency {};
+};
+
+AudioSettingsDialog::AudioSettingsDialog(QWidget *parent)
+  : QDialog(parent), P(new Impl) {
+  this->setWindowTitle("Audio settings");
+
+  QVBoxLayout *layout = new QVBoxLayout;
+  this->setLayout(layout);
+
+  QFormLayout *form = new QFormLayout;
+  layout->addLayout(form);
+
+  P->selPeriod = new QComboBox;
+  for (unsigned period : {64, 128, 256, 512, 1024})
+    P->selPeriod->addItem(QString::number(period), period);
+  form->addRow("Period (frames)", P->selPeriod);
+
+  P->valPeriods = new QSpinBox;
+  P->valPeriods->setRange(2, 16);
+  form->addRow("Number of periods", P->valPeriods);
+
+  P->lblLatency = new QLabel;
+  form->addRow("Buffered latency", P->lblLatency);
+
+  QDialogButtonBox *buttonbox = new QDialogButtonBox(
+    QDialogButtonBox::Ok|QDialogButtonBox::Cancel);
+  layout->addWidget(buttonbox);
+
+  QObject::connect(P->selPeriod, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+                   this, &AudioSettingsDialog::updateLatency);
+  QObject::connect(P->valPeriods, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+                   this, &AudioSettingsDialog::updateLatency);
+
+  QObject::connect(buttonbox, &QDialogButtonBox::accepted,
+                   this, &AudioSettingsDialog::accept);
+  QObject::connect(buttonbox, &QDialogButtonBox::rejected,
+                   this, &AudioSettingsDialog::reject);
+
+  updateLatency();
+}
+
+AudioSettingsDialog::~AudioSettingsDialog() {
+}
+
+unsigned AudioSettingsDialog::period() const {
+  return P->selPeriod->currentData().toUInt();
+}
+
+void AudioSettingsDialog::setPeriod(unsigned period) {
+  int index = P->selPeriod->findData(period);
+  if (index != -1)
+    P->selPeriod->setCurrentIndex(index);
+}
+
+unsigned AudioSettingsDialog::periods() const {
+  return P->valPeriods->value();
+}
+
+void AudioSettingsDialog::setPeriods(unsigned periods) {
+  P->valPeriods->setValue(periods);
+}
+
+void AudioSettingsDialog::updateLatency() {
+  // the ring of the render thread, and as much again in the device
+  double rate = ::audio_format.sampleRate();
+  double latency = (rate > 0) ? (2.0 * period() * periods() / rate) : 0.0;
+  P->lblLatency->setText(QString("up to %0 ms").arg(1e3 * latency, 0, 'f', 1));
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <QDialog>
+#include <memory>
+
+class AudioSettingsDialog : public QDialog {
+  Q_OBJECT;
+ public:
+  explicit AudioSettingsDialog(QWidget *parent = nullptr);
+  ~AudioSettingsDialog();
+
+  unsigned period() const;
+  void setPeriod(unsigned period);
+  unsigned periods() const;
+  void setPeriods(unsigned periods);
+
+ private slots:
+  void updateLatency();
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> P;
+};
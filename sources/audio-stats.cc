@@ -0,0 +1,105 @@
+#include "audio-stats.h"
+#include <ostream>
+#include <iomanip>
+
+static const std::memory_order relaxed = std::memory_order_relaxed;
+
+void AudioStats::recordRead(uint64_t nanos, unsigned frames, unsigned silent) {
+  reads_.fetch_add(1, relaxed);
+  readNanos_.fetch_add(nanos, relaxed);
+  readHistogram_[bucketOf(nanos)].fetch_add(1, relaxed);
+  framesRead_.fetch_add(frames, relaxed);
+  // one writer, no need to compare and swap
+  if (nanos > readMaxNanos_.load(relaxed))
+    readMaxNanos_.store(nanos, relaxed);
+  if (silent > 0) {
+    ringUnderruns_.fetch_add(1, relaxed);
+    silentFrames_.fetch_add(silent, relaxed);
+  }
+}
+
+void AudioStats::recordRender(uint64_t nanos, unsigned frames) {
+  renderNanos_.fetch_add(nanos, relaxed);
+  framesRendered_.fetch_add(frames, relaxed);
+}
+
+void AudioStats::reset() {
+  reads_.store(0, relaxed);
+  readNanos_.store(0, relaxed);
+  readMaxNanos_.store(0, relaxed);
+  for (std::atomic<uint64_t> &count : readHistogram_)
+    count.store(0, relaxed);
+  framesRead_.store(0, relaxed);
+  ringUnderruns_.store(0, relaxed);
+  silentFrames_.store(0, relaxed);
+  renderNanos_.store(0, relaxed);
+  framesRendered_.store(0, relaxed);
+  deviceUnderruns_.store(0, relaxed);
+  deviceErrors_.store(0, relaxed);
+}
+
+AudioStats::Snapshot AudioStats::snapshot() const {
+  Snapshot s;
+  s.reads = reads_.load(relaxed);
+  s.readNanos = readNanos_.load(relaxed);
+  s.readMaxNanos = readMaxNanos_.load(relaxed);
+  for (unsigned i = 0; i < bucketCount; ++i)
+    s.readHistogram[i] = readHistogram_[i].load(relaxed);
+  s.framesRead = framesRead_.load(relaxed);
+  s.ringUnderruns = ringUnderruns_.load(relaxed);
+  s.silentFrames = silentFrames_.load(relaxed);
+  s.renderNanos = renderNanos_.load(relaxed);
+  s.framesRendered = framesRendered_.load(relaxed);
+  s.deviceUnderruns = deviceUnderruns_.load(relaxed);
+  s.deviceErrors = deviceErrors_.load(relaxed);
+  return s;
+}
+
+unsigned AudioStats::bucketOf(uint64_t nanos) {
+  uint64_t micros = nanos / 1000;
+  unsigned bucket = 0;
+  while (micros > 0 && bucket < bucketCount - 1) {
+    micros >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+double render_load(const AudioStats::Snapshot &from, const AudioStats::Snapshot &to,
+                   double sampleRate) {
+  uint64_t frames = to.framesRendered - from.framesRendered;
+  if (frames == 0 || sampleRate <= 0)
+    return 0;
+  double audio_nanos = 1e9 * frames / sampleRate;
+  return (to.renderNanos - from.renderNanos) / audio_nanos;
+}
+
+void write_audio_stats(const AudioStats::Snapshot &stats, double sampleRate, std::ostream &out) {
+  AudioStats::Snapshot zero {};
+
+  out << "reads: " << stats.reads << "\n";
+  out << "frames read: " << stats.framesRead << "\n";
+  out << "frames rendered: " << stats.framesRendered << "\n";
+  out << "ring underruns: " << stats.ringUnderruns
+      << " (" << stats.silentFrames << " silent frames)\n";
+  out << "device underruns: " << stats.deviceUnderruns << "\n";
+  out << "device errors: " << stats.deviceErrors << "\n";
+  out << "render load: " << std::fixed << std::setprecision(2)
+      << 100.0 * render_load(zero, stats, sampleRate) << " %\n";
+  if (stats.reads > 0)
+    out << "read time: mean " << 1e-3 * stats.readNanos / stats.reads
+        << " us, max " << 1e-3 * stats.readMaxNanos << " us\n";
+
+  out << "read time histogram:\n";
+  for (unsigned i = 0; i < AudioStats::bucketCount; ++i) {
+    uint64_t count = stats.readHistogram[i];
+    if (count == 0)
+      continue;
+    out << "  " << std::setw(6) << AudioStats::bucketStart(i) << " us ";
+    if (i < AudioStats::bucketCount - 1)
+      out << "- " << std::setw(6) << AudioStats::bucketStart(i + 1) << " us";
+    else
+      out << "and more ";
+    out << ": " << count << "\n";
+  }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <iosfwd>
+#include <cstdint>
+
+// counters of the audio path, for telling why playback crackles
+//   The audio and render threads record with relaxed atomics only, never
+//   allocating or locking; the GUI thread reads snapshots at any time.
+class AudioStats {
+ public:
+  // time per read of the device, in buckets of powers of 2 microseconds:
+  //   bucket 0 under 1 us, bucket k from 2^(k-1) to 2^k us, the last open
+  static const unsigned bucketCount = 16;
+
+  struct Snapshot {
+    uint64_t reads;
+    uint64_t readNanos;
+    uint64_t readMaxNanos;
+    uint64_t readHistogram[bucketCount];
+    uint64_t framesRead;
+    uint64_t ringUnderruns;
+    uint64_t silentFrames;
+    uint64_t renderNanos;
+    uint64_t framesRendered;
+    uint64_t deviceUnderruns;
+    uint64_t deviceErrors;
+  };
+
+  AudioStats() { reset(); }
+
+  // audio thread, a read of the device, with frames the ring lacked
+  void recordRead(uint64_t nanos, unsigned frames, unsigned silent);
+  // render thread, a period rendered
+  void recordRender(uint64_t nanos, unsigned frames);
+  // GUI thread, from the state of the device
+  void recordDeviceUnderrun() { deviceUnderruns_.fetch_add(1, std::memory_order_relaxed); }
+  void recordDeviceError() { deviceErrors_.fetch_add(1, std::memory_order_relaxed); }
+
+  void reset();
+  Snapshot snapshot() const;
+
+  static unsigned bucketOf(uint64_t nanos);
+  // the lower bound of a bucket, in microseconds
+  static uint64_t bucketStart(unsigned bucket) { return bucket ? uint64_t(1) << (bucket - 1) : 0; }
+
+ private:
+  std::atomic<uint64_t> reads_;
+  std::atomic<uint64_t> readNanos_;
+  std::atomic<uint64_t> readMaxNanos_;
+  std::atomic<uint64_t> readHistogram_[bucketCount];
+  std::atomic<uint64_t> framesRead_;
+  std::atomic<uint64_t> ringUnderruns_;
+  std::atomic<uint64_t> silentFrames_;
+  std::atomic<uint64_t> renderNanos_;
+  std::atomic<uint64_t> framesRendered_;
+  std::atomic<uint64_t> deviceUnderruns_;
+  std::atomic<uint64_t> deviceErrors_;
+};
+
+// the render time per time of audio rendered, between two snapshots
+double render_load(const AudioStats::Snapshot &from, const AudioStats::Snapshot &to,
+                   double sampleRate);
+
+// a readable report of the counters
+void write_audio_stats(const AudioStats::Snapshot &stats, double sampleRate, std::ostream &out);
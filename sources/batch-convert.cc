@@ -0,0 +1,285 @@
+#include "batch-convert.h"
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+static const char *format_suffix(WaveFormat fmt) {
+  return (fmt == WaveDat) ? ".dat" : (fmt == WaveRiff) ? ".wav" : ".h";
+}
+
+static bool guess_input_format(const std::string &path, WaveFormat &fmt) {
+  size_t dot = path.rfind('.');
+  size_t slash = path.rfind('/');
+  if (dot == path.npos || (slash != path.npos && dot < slash))
+    return false;
+
+  std::string suffix = boost::to_lower_copy(path.substr(dot));
+  if (suffix == ".dat" || suffix == ".txt") {
+    fmt = WaveDat;
+    return true;
+  }
+  if (suffix == ".wav") {
+    fmt = WaveRiff;
+    return true;
+  }
+  for (const char *source : {".h", ".hh", ".hpp", ".c", ".cc", ".cpp"}) {
+    if (suffix == source) {
+      fmt = WaveCpp;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string batch_output_path(const std::string &input, const BatchConvert &settings) {
+  size_t slash = input.rfind('/');
+  std::string dir = (slash == input.npos) ? "" : input.substr(0, slash + 1);
+  std::string name = (slash == input.npos) ? input : input.substr(slash + 1);
+
+  size_t dot = name.rfind('.');
+  if (dot != name.npos && dot > 0)
+    name.resize(dot);
+
+  if (!settings.outputDirectory.empty()) {
+    dir = settings.outputDirectory;
+    if (dir.back() != '/')
+      dir.push_back('/');
+  }
+
+  return dir + name + format_suffix(settings.outputFormat);
+}
+
+bool convert_wave_file(const std::string &input, const BatchConvert &settings,
+                       std::string &error) {
+  WaveFormat infmt = settings.inputFormat;
+  if (settings.guessInputFormat && !guess_input_format(input, infmt)) {
+    error = "unknown input format";
+    return false;
+  }
+
+  std::string output = batch_output_path(input, settings);
+  if (output == input) {
+    error = "output would replace the input";
+    return false;
+  }
+
+  std::vector<float> samples;
+  bool have_samples;
+  if (settings.allFrames)
+    have_samples = read_wave_bank_from_file(
+      samples, settings.outputSize, input, infmt, settings.channel,
+      settings.quality, settings.frameLength, settings.jobs);
+  else {
+    samples.resize(settings.outputSize);
+    have_samples = read_wave_from_file(
+      samples.data(), samples.size(), input, infmt, settings.channel,
+      settings.quality, settings.frameLength, settings.frame);
+  }
+  if (!have_samples) {
+    error = std::ifstream(input) ? "cannot read wave data" : "cannot open";
+    return false;
+  }
+
+  std::ofstream out(output, std::ios::binary);
+  write_wave(samples.data(), samples.size(), samples.size(),
+             settings.outputFormat, settings.outputType, out, settings.quality);
+  out.flush();
+
+  if (!out) {
+    out.close();
+    std::remove(output.c_str());
+    error = "cannot write " + output;
+    return false;
+  }
+
+  return true;
+}
+
+unsigned batch_convert(const std::vector<std::string> &inputs,
+                       const BatchConvert &settings) {
+  unsigned jobs = settings.jobs;
+  if (jobs == 0)
+    jobs = std::max(1u, std::thread::hardware_concurrency());
+  const unsigned total_jobs = jobs;
+  jobs = std::min<size_t>(jobs, inputs.size());
+
+  // the threads left over from the files go to the tables of banks
+  BatchConvert file_settings = settings;
+  file_settings.jobs = std::max(1u, total_jobs / std::max(1u, jobs));
+
+  // the workers take the next file until there is none left
+  std::atomic<size_t> next {0};
+  std::vector<std::string> errors(inputs.size());
+  std::vector<char> failed(inputs.size());
+
+  auto work = [&]() {
+    for (size_t i = next++; i < inputs.size(); i = next++) {
+      try {
+        failed[i] = !convert_wave_file(inputs[i], file_settings, errors[i]);
+      } catch (std::exception &ex) {
+        failed[i] = true;
+        errors[i] = ex.what();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned j = 1; j < jobs; ++j)
+    workers.emplace_back(work);
+  work();
+  for (std::thread &worker : workers)
+    worker.join();
+
+  // the failures, in the order of the inputs
+  unsigned failures = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (failed[i]) {
+      std::cerr << inputs[i] << ": " << errors[i] << "\n";
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+static void convert_usage(std::ostream &out) {
+  out << "Usage: dessiner-un-son convert [options] file...\n"
+         "\n"
+         "Options:\n"
+         "  -f, --input-format dat|cpp|c|wav\n"
+         "                                  format of inputs (default: by suffix)\n"
+         "  -c, --channel N                 column, array or channel to read (default: 0)\n"
+         "  -l, --frame-length N            samples of each table of a bank (default: all)\n"
+         "  -n, --frame N                   table of a bank to read (default: 0)\n"
+         "  -a, --all-frames                every table of a bank, to a bank of the output size\n"
+         "  -s, --size N                    samples of output (default: 1024)\n"
+         "  -F, --output-format dat|cpp|c|wav\n"
+         "                                  format of outputs (default: cpp)\n"
+         "  -t, --type float|int16|int24|int8\n"
+         "                                  data type of outputs (default: float)\n"
+         "  -q, --quality linear|fast|medium|best|periodic\n"
+         "                                  resampling (default: periodic)\n"
+         "  -o, --output-dir DIR            directory of outputs (default: of inputs)\n"
+         "  -j, --jobs N                    threads (default: one per processor)\n"
+         "  -h, --help                      show this help\n";
+}
+
+static bool parse_format(const std::string &name, WaveFormat &fmt) {
+  if (name == "dat") fmt = WaveDat;
+  else if (name == "cpp") fmt = WaveCpp;
+  else if (name == "c") fmt = WaveC;
+  else if (name == "wav") fmt = WaveRiff;
+  else return false;
+  return true;
+}
+
+static bool parse_type(const std::string &name, WaveDataType &type) {
+  if (name == "float") type = WaveFloat;
+  else if (name == "int16") type = WaveInt16;
+  else if (name == "int24") type = WaveInt24;
+  else if (name == "int8") type = WaveInt8;
+  else return false;
+  return true;
+}
+
+static bool parse_quality(const std::string &name, ResampleQuality &quality) {
+  if (name == "linear") quality = ResampleLinear;
+  else if (name == "fast") quality = ResampleSpeexFast;
+  else if (name == "medium") quality = ResampleSpeexMedium;
+  else if (name == "best") quality = ResampleSpeexBest;
+  else if (name == "periodic") quality = ResamplePeriodic;
+  else return false;
+  return true;
+}
+
+static bool parse_unsigned(const std::string &text, unsigned &value) {
+  char *end;
+  unsigned long number = std::strtoul(text.c_str(), &end, 10);
+  if (text.empty() || *end != '\0' || text[0] == '-')
+    return false;
+  value = number;
+  return true;
+}
+
+int batch_convert_main(int argc, char *argv[]) {
+  BatchConvert settings;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+
+    if (arg == "-h" || arg == "--help") {
+      convert_usage(std::cout);
+      return 0;
+    }
+    if (arg == "-a" || arg == "--all-frames") {
+      settings.allFrames = true;
+      continue;
+    }
+    if (arg == "--") {
+      inputs.insert(inputs.end(), argv + i + 1, argv + argc);
+      break;
+    }
+    if (arg.empty() || arg[0] != '-') {
+      inputs.push_back(arg);
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      std::cerr << "missing value of " << arg << "\n";
+      return 1;
+    }
+    std::string value = argv[++i];
+
+    bool valid;
+    if (arg == "-f" || arg == "--input-format") {
+      valid = parse_format(value, settings.inputFormat);
+      settings.guessInputFormat = false;
+    }
+    else if (arg == "-c" || arg == "--channel")
+      valid = parse_unsigned(value, settings.channel);
+    else if (arg == "-l" || arg == "--frame-length")
+      valid = parse_unsigned(value, settings.frameLength);
+    else if (arg == "-n" || arg == "--frame")
+      valid = parse_unsigned(value, settings.frame);
+    else if (arg == "-s" || arg == "--size")
+      valid = parse_unsigned(value, settings.outputSize) && settings.outputSize > 0;
+    else if (arg == "-F" || arg == "--output-format")
+      valid = parse_format(value, settings.outputFormat);
+    else if (arg == "-t" || arg == "--type")
+      valid = parse_type(value, settings.outputType);
+    else if (arg == "-q" || arg == "--quality")
+      valid = parse_quality(value, settings.quality);
+    else if (arg == "-o" || arg == "--output-dir")
+      valid = !(settings.outputDirectory = value).empty();
+    else if (arg == "-j" || arg == "--jobs")
+      valid = parse_unsigned(value, settings.jobs);
+    else {
+      std::cerr << "unknown option " << arg << "\n";
+      convert_usage(std::cerr);
+      return 1;
+    }
+
+    if (!valid) {
+      std::cerr << "invalid value of " << arg << ": " << value << "\n";
+      return 1;
+    }
+  }
+
+  if (inputs.empty()) {
+    convert_usage(std::cerr);
+    return 1;
+  }
+
+  unsigned failures = batch_convert(inputs, settings);
+  if (failures > 0) {
+    std::cerr << failures << " of " << inputs.size() << " files failed\n";
+    return 1;
+  }
+  return 0;
+}
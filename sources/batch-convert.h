@@ -0,0 +1,38 @@
+#pragma once
+#include "wave-io.h"
+#include <string>
+#include <vector>
+
+struct BatchConvert {
+  // the input format, if not guessed from the suffix of each file
+  bool guessInputFormat = true;
+  WaveFormat inputFormat = WaveDat;
+  unsigned channel = 0;
+  // the table of a bank to read, if the inputs are banks of tables
+  unsigned frameLength = 0;
+  unsigned frame = 0;
+  // every table of the bank, converted to a bank of tables of `outputSize`
+  bool allFrames = false;
+  unsigned outputSize = 1024;
+  WaveFormat outputFormat = WaveCpp;
+  WaveDataType outputType = WaveFloat;
+  ResampleQuality quality = ResamplePeriodic;
+  // the directory of outputs, if not the one of each input
+  std::string outputDirectory;
+  // the number of threads, 0 for one per processor
+  unsigned jobs = 0;
+};
+
+// the file an input converts to
+std::string batch_output_path(const std::string &input, const BatchConvert &settings);
+
+// converts one file, false with a reason in `error` on failure
+bool convert_wave_file(const std::string &input, const BatchConvert &settings,
+                       std::string &error);
+
+// converts files in parallel, gives the count of failures
+unsigned batch_convert(const std::vector<std::string> &inputs,
+                       const BatchConvert &settings);
+
+// `dessiner-un-son convert [options] file...`, without GUI or audio
+int batch_convert_main(int argc, char *argv[]);
@@ -0,0 +1,50 @@
+#include "cpu-dispatch.h"
+#include <cstdio>
+#include <cstdlib>
+#include <strings.h>
+
+static CpuPath detect_cpu_path() {
+#if defined(DESSINER_X86_SIMD)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return CpuAVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return CpuSSE2;
+#endif
+  return CpuGeneric;
+}
+
+// the path detected, or a lesser one named by DESSINER_CPU_PATH
+//   called by static initializers, so it reports by stdio, not iostreams
+static CpuPath select_cpu_path() {
+  CpuPath path = detect_cpu_path();
+
+  const char *forced = getenv("DESSINER_CPU_PATH");
+  if (!forced || !*forced)
+    return path;
+
+  static const char *names[] = CPU_PATH_NAMES;
+  for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    if (strcasecmp(forced, names[i]) != 0)
+      continue;
+    if (CpuPath(i) > path) {
+      fprintf(stderr, "the processor does not support the path %s, using %s\n",
+              names[i], names[path]);
+      return path;
+    }
+    return CpuPath(i);
+  }
+
+  fprintf(stderr, "unknown processor path %s, using %s\n", forced, names[path]);
+  return path;
+}
+
+CpuPath cpu_path() {
+  static const CpuPath path = select_cpu_path();
+  return path;
+}
+
+const char *cpu_path_name(CpuPath path) {
+  static const char *names[] = CPU_PATH_NAMES;
+  return names[path];
+}
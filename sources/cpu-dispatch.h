@@ -0,0 +1,18 @@
+#pragma once
+
+// instruction sets of the hot loops, in order of preference
+enum CpuPath {
+  CpuGeneric,
+  CpuSSE2,
+  CpuAVX2,
+};
+
+#define CPU_PATH_NAMES                          \
+  {"generic", "SSE2", "AVX2"}
+
+// the best path supported by both the processor and the build
+//   detected once by cpuid, then constant; a lesser path can be forced
+//   by naming it in the environment variable DESSINER_CPU_PATH
+CpuPath cpu_path();
+
+const char *cpu_path_name(CpuPath path);
@@ -1,10 +1,13 @@
 #include "dot-editor-widget.h"
 #include "math-dsp.h"
+#include "phase-warp.h"
 #include <QPainter>
 #include <QMouseEvent>
 #include <QDebug>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <vector>
+#include <memory>
 #include <cmath>
 
 struct BasicDotEditorWidget::Impl {
@@ -20,6 +23,12 @@ struct BasicDotEditorWidget::Impl {
   const int ydots {};
   std::vector<double> dotdata;
   boost::optional<QPoint> mousepos;
+  // the window last applied, kept for the next of the same parameter
+  std::unique_ptr<TukeyWindow> window;
+  std::unique_ptr<PhaseWarp> warp;
+  // the data under a preview
+  bool previewing = false;
+  std::vector<double> original;
 };
 
 BasicDotEditorWidget::BasicDotEditorWidget(int xdots, int ydots, QWidget *parent)
@@ -37,75 +46,75 @@ void BasicDotEditorWidget::initialize() {
   this->setMaximumSize(size);
 }
 
-void BasicDotEditorWidget::smooth(double param) {
-  if (param <= 0.0 || param > 1.0)
-    return;
+void BasicDotEditorWidget::previewFilter(TableFilter filter, double cutoff) {
+  if (!P->previewing) {
+    P->original = P->dotdata;
+    P->previewing = true;
+  }
 
-  double adj = 100.0;  // adjust cutoff
-  double s = std::exp(-1.0 / (adj * (1.0 - param)));
+  std::copy(P->original.begin(), P->original.end(), P->dotdata.begin());
+  filter_table(P->dotdata.data(), P->xdots, filter, cutoff);
+  this->update();
+}
 
-  for (int i = 0; i < P->xdots; ++i) {
-    double input = P->dotdata[i];
-    double nextinput = (i + 1 < P->xdots) ? P->dotdata[i + 1] : input;
-    P->dotdata[i] = nextinput * (1.0 - s) + input * s;
+void BasicDotEditorWidget::previewPhaseWarp(double amount) {
+  if (!P->previewing) {
+    P->original = P->dotdata;
+    P->previewing = true;
   }
 
+  if (!P->warp || P->warp->amount() != amount)
+    P->warp.reset(new PhaseWarp(amount, P->xdots));
+  P->warp->apply(P->original.data(), P->dotdata.data());
   this->update();
 }
 
-void BasicDotEditorWidget::window(double param) {
-  for (int i = 0; i < P->xdots; ++i) {
-    double x = double(i) / (P->xdots - 1);
-    double w = tukey_window(param, x);
-    P->dotdata[i] *= w;
-  }
+void BasicDotEditorWidget::cancelPreview() {
+  if (!P->previewing)
+    return;
 
+  P->dotdata = P->original;
+  P->previewing = false;
   this->update();
 }
 
+bool BasicDotEditorWidget::inPreview() const {
+  return P->previewing;
+}
+
+void BasicDotEditorWidget::window(double param) {
+  if (!P->window || P->window->a() != param)
+    P->window.reset(new TukeyWindow(param, P->xdots));
+
+  P->window->apply(P->dotdata.data());
+  this->notifyDataChanged();
+}
+
 void BasicDotEditorWidget::shiftData(int off) {
-  std::vector<double> newdata(P->xdots);
-  for (int x = 0; x < P->xdots; ++x) {
-    int newx = x - off;
-    double s;
-    if (newx < 0)
-      s = P->dotdata[0];
-    else if (newx >= P->xdots)
-      s = P->dotdata[P->xdots - 1];
-    else
-      s = P->dotdata[newx];
-    newdata[x] = s;
-  }
-  std::copy(newdata.begin(), newdata.end(), P->dotdata.begin());
-  this->update();
+  shift_samples(P->dotdata.data(), P->xdots, off);
+  this->notifyDataChanged();
 }
 
 void BasicDotEditorWidget::invert(int sides) {
   int xmid = P->xdots / 2;
 
-  if (sides & LeftSide) {
-    for (int i = 0; i < xmid; ++i)
-      P->dotdata[i] = -P->dotdata[i];
-  }
-  if (sides & RightSide) {
-    for (int i = xmid; i < P->xdots; ++i)
-      P->dotdata[i] = -P->dotdata[i];
-  }
+  if (sides & LeftSide)
+    negate_samples(P->dotdata.data(), xmid);
+  if (sides & RightSide)
+    negate_samples(P->dotdata.data() + xmid, P->xdots - xmid);
 
-  this->update();
+  this->notifyDataChanged();
 }
 
 void BasicDotEditorWidget::mirror(MirrorDir mirrordir) {
   switch (mirrordir) {
     case MirLeftToRight:
-      for (int i = 0; i < P->xdots / 2; ++i)
-        P->dotdata[P->xdots - i - 1] = P->dotdata[i];
-      this->update();
+      mirror_samples(P->dotdata.data(), P->xdots, true);
+      this->notifyDataChanged();
       break;
     case MirRightToLeft:
-      for (int i = 0; i < P->xdots / 2; ++i)
-        P->dotdata[i] = P->dotdata[P->xdots - i - 1];
-      this->update();
+      mirror_samples(P->dotdata.data(), P->xdots, false);
+      this->notifyDataChanged();
       break;
   }
 }
@@ -118,6 +127,12 @@ std::vector<double> &BasicDotEditorWidget::dotData() {
   return P->dotdata;
 }
 
+void BasicDotEditorWidget::notifyDataChanged() {
+  P->previewing = false;
+  this->update();
+  emit dataChanged();
+}
+
 bool BasicDotEditorWidget::inGridBounds(QPoint gridpos) const {
   int x = gridpos.x(), y = gridpos.y();
   return x >= 0 && y >= 0 && x < P->xdots && y < P->ydots;
@@ -148,7 +163,7 @@ void BasicDotEditorWidget::mousePressEvent(QMouseEvent *event) {
     // qDebug() << "paint dot by click" << pos;
     this->activateDot(gridpos);
     P->mousepos = pos;
-    this->update();
+    this->notifyDataChanged();
   }
 }
 
@@ -172,7 +187,7 @@ void BasicDotEditorWidget::mouseMoveEvent(QMouseEvent *event) {
       // qDebug() << "paint dot by move" << pos;
       this->activateDot(gridpos);
     }
-    this->update();
+    this->notifyDataChanged();
   }
 
   if (!inbounds) {
@@ -357,3 +372,61 @@ void CompactDotEditorWidget::paintMouseIndicator(QPainter &painter) const {
 QPoint CompactDotEditorWidget::toGridCoord(QPoint pos) const {
   return QPoint(pos.x(), pos.y());
 }
+
+///
+BarEditorWidget::BarEditorWidget(int xbars, int ydots, int barwidth, Baseline baseline, QWidget *parent)
+  : BasicDotEditorWidget(xbars, ydots, parent)
+  , barwidth((barwidth > 1) ? barwidth : 1), baseline(baseline) {
+  double rest = (baseline == BarsFromBottom) ? -1.0 : 0.0;
+  std::fill(P->dotdata.begin(), P->dotdata.end(), rest);
+}
+
+QSize BarEditorWidget::sizeHint() const {
+  return QSize(barwidth * P->xdots + 1, P->ydots);
+}
+
+void BarEditorWidget::paintGrid(QPainter &painter) const {
+  const QSize size = this->sizeHint();
+  painter.setPen(Qt::darkGray);
+  for (int x = 0; x < P->xdots; x += 8)
+    painter.drawLine(QLine(barwidth * x, 0, barwidth * x, size.height() - 1));
+}
+
+void BarEditorWidget::paintAxes(QPainter &painter) const {
+  const QSize size = this->sizeHint();
+  painter.setPen(Qt::lightGray);
+  int ybase = (baseline == BarsFromBottom) ? (size.height() - 1) : (size.height() / 2);
+  painter.drawLine(0, ybase, size.width() - 1, ybase);
+}
+
+void BarEditorWidget::paintDot(int x, int y, QColor color, QPainter &painter) const {
+  painter.fillRect(QRect(x * barwidth + 1, y, std::max(1, barwidth - 1), 1), color);
+}
+
+void BarEditorWidget::paintMouseIndicator(QPainter &painter) const {
+  if (!P->mousepos)
+    return;
+  QPoint gridpos = this->toGridCoord(*P->mousepos);
+  painter.setPen(Qt::gray);
+  painter.drawRect(gridpos.x() * barwidth, 0, barwidth, P->ydots - 1);
+}
+
+QPoint BarEditorWidget::toGridCoord(QPoint pos) const {
+  int x = pos.x() / barwidth;
+  int y = pos.y();
+  x = (x < 0) ? 0 : (x >= P->xdots) ? (P->xdots - 1) : x;
+  y = (y < 0) ? 0 : (y >= P->ydots) ? (P->ydots - 1) : y;
+  return QPoint(x, y);
+}
+
+void BarEditorWidget::paintDots(QPainter &painter) const {
+  int ybase = (baseline == BarsFromBottom) ? (P->ydots - 1) : (P->ydots / 2);
+  for (int x = 0; x < P->xdots; ++x) {
+    double val = P->dotdata[x];
+    val = (1.0 - val) * 0.5;
+    val = (val < 0.0) ? 0.0 : (val > +1.0) ? +1.0 : val;
+    int y = val * (P->ydots - 1);
+    int y1 = std::min(y, ybase), y2 = std::max(y, ybase);
+    painter.fillRect(QRect(x * barwidth + 1, y1, std::max(1, barwidth - 1), y2 - y1 + 1), Qt::red);
+  }
+}
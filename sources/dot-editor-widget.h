@@ -1,4 +1,5 @@
 #pragma once
+#include "math-filter.h"
 #include <QWidget>
 #include <QBitArray>
 #include <memory>
@@ -16,7 +17,14 @@ class BasicDotEditorWidget : public QWidget {
   void mouseReleaseEvent(QMouseEvent *event) override;
   void mouseMoveEvent(QMouseEvent *event) override;
 
-  void smooth(double param);
+  // shows the filtered data, filtered again from the data as it was
+  // before the first preview, until committed by any change or cancelled
+  void previewFilter(TableFilter filter, double cutoff);
+  // the same, with the phase distorted by an amount in [-1, 1]
+  void previewPhaseWarp(double amount);
+  void cancelPreview();
+  bool inPreview() const;
+
   void window(double param);
   void shiftData(int off);
 
@@ -34,8 +42,13 @@ class BasicDotEditorWidget : public QWidget {
 
   bool inGridBounds(QPoint gridpos) const;
 
+ public slots:
+  // call after modifying the data from outside
+  void notifyDataChanged();
+
  signals:
   void hoveredGridCoord(QPoint gridpoint);
+  void dataChanged();
 
  protected:
   struct Impl;
@@ -54,7 +67,7 @@ class BasicDotEditorWidget : public QWidget {
 
   void setPrecisionCursor();
 
-  void paintDots(QPainter &painter) const;
+  virtual void paintDots(QPainter &painter) const;
 };
 
 ///
@@ -91,3 +104,29 @@ class CompactDotEditorWidget : public BasicDotEditorWidget {
 
   QPoint toGridCoord(QPoint pos) const override;
 };
+
+///
+// one bar per column, drawn from the bottom or from the center
+class BarEditorWidget : public BasicDotEditorWidget {
+  Q_OBJECT;
+ public:
+  enum Baseline { BarsFromBottom, BarsFromCenter };
+
+  BarEditorWidget(int xbars, int ydots, int barwidth, Baseline baseline, QWidget *parent = nullptr);
+
+  QSize sizeHint() const override;
+
+  void paintGrid(QPainter &painter) const override;
+  void paintAxes(QPainter &painter) const override;
+  void paintDot(int x, int y, QColor color, QPainter &painter) const override;
+  void paintMouseIndicator(QPainter &painter) const override;
+
+  QPoint toGridCoord(QPoint pos) const override;
+
+ protected:
+  void paintDots(QPainter &painter) const override;
+
+ private:
+  const int barwidth = 1;
+  const Baseline baseline = BarsFromBottom;
+};
@@ -0,0 +1,114 @@
+#include "harmonic-editor.h"
+#include "harmonic-spectrum.h"
+#include "dot-editor-widget.h"
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+
+struct HarmonicEditor::Impl {
+  unsigned size {};
+  unsigned harmonics {};
+  BarEditorWidget *amplitudes = nullptr;
+  BarEditorWidget *phases = nullptr;
+  // the offset is kept from the last table, it has no bar
+  double offset = 0;
+  std::vector<double> table;
+  std::vector<double> amp, phase;
+};
+
+// the range of amplitudes drawn, the bottom being silence
+static const double floor_db = -60.0;
+
+static double amplitude_of_bar(double value) {
+  double level = (value + 1.0) * 0.5;
+  return (level > 0.0) ? std::pow(10.0, (1.0 - level) * floor_db / 20.0) : 0.0;
+}
+
+static double bar_of_amplitude(double amp) {
+  double level = (amp > 0.0) ? 1.0 - 20.0 * std::log10(amp) / floor_db : 0.0;
+  level = (level < 0.0) ? 0.0 : (level > 1.0) ? 1.0 : level;
+  return level * 2.0 - 1.0;
+}
+
+HarmonicEditor::HarmonicEditor(unsigned size, unsigned harmonics, QWidget *parent)
+  : QWidget(parent), P(new Impl) {
+  harmonics = std::min(harmonics, size / 2);
+  P->size = size;
+  P->harmonics = harmonics;
+  P->table.resize(size);
+  P->amp.resize(harmonics);
+  P->phase.resize(harmonics);
+
+  int barwidth = std::max(1, 512 / int(harmonics));
+  P->amplitudes = new BarEditorWidget(harmonics, 256, barwidth, BarEditorWidget::BarsFromBottom);
+  P->phases = new BarEditorWidget(harmonics, 128, barwidth, BarEditorWidget::BarsFromCenter);
+  P->amplitudes->initialize();
+  P->phases->initialize();
+  P->amplitudes->setToolTip("Amplitudes of the harmonics, from -60 dB to 0 dB");
+  P->phases->setToolTip("Phases of the harmonics, from -π to π");
+
+  QVBoxLayout *layout = new QVBoxLayout;
+  layout->setContentsMargins(0, 0, 0, 0);
+  layout->addWidget(P->amplitudes);
+  layout->addWidget(P->phases);
+  this->setLayout(layout);
+
+  connect(P->amplitudes, &BasicDotEditorWidget::dataChanged,
+          this, &HarmonicEditor::synthesize);
+  connect(P->phases, &BasicDotEditorWidget::dataChanged,
+          this, &HarmonicEditor::synthesize);
+}
+
+HarmonicEditor::~HarmonicEditor() {
+}
+
+const std::vector<double> &HarmonicEditor::tableData() const {
+  return P->table;
+}
+
+void HarmonicEditor::setData(const std::vector<double> &data) {
+  if (data == P->table)
+    return;
+
+  const unsigned count = P->harmonics;
+  HarmonicSpectrum spectrum(count);
+  spectrum.reset(data.data(), data.size());
+  P->offset = data.empty() ? 0.0 : spectrum.bin(0).real() / data.size();
+
+  std::vector<double> &amps = P->amplitudes->dotData();
+  std::vector<double> &phases = P->phases->dotData();
+  for (unsigned k = 1; k <= count; ++k) {
+    bool present = k <= spectrum.harmonics();
+    amps[k - 1] = bar_of_amplitude(present ? spectrum.amplitude(k) : 0.0);
+    phases[k - 1] = present ? spectrum.phase(k) / M_PI : 0.0;
+  }
+  P->amplitudes->update();
+  P->phases->update();
+
+  P->table = data;
+}
+
+void HarmonicEditor::synthesize() {
+  const unsigned count = P->harmonics;
+  const std::vector<double> &amps = P->amplitudes->dotData();
+  const std::vector<double> &phases = P->phases->dotData();
+  for (unsigned k = 0; k < count; ++k) {
+    P->amp[k] = amplitude_of_bar(amps[k]);
+    P->phase[k] = phases[k] * M_PI;
+  }
+
+  std::vector<double> &table = P->table;
+  synthesize_harmonics(P->offset, P->amp.data(), P->phase.data(), count,
+                       table.data(), P->size);
+
+  // scaled down when the harmonics add above full scale
+  double peak = 0;
+  for (double x : table)
+    peak = std::max(peak, std::fabs(x));
+  if (peak > 1.0) {
+    for (double &x : table)
+      x /= peak;
+  }
+
+  emit dataChanged();
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <QWidget>
+#include <vector>
+#include <memory>
+
+// the table drawn as amplitudes and phases of its harmonics
+//   Each edit rebuilds the table by an inverse transform, which is
+//   band-limited to the harmonics drawn.
+class HarmonicEditor : public QWidget {
+  Q_OBJECT;
+ public:
+  HarmonicEditor(unsigned size, unsigned harmonics = 256, QWidget *parent = nullptr);
+  ~HarmonicEditor();
+
+  // the table as last synthesized
+  const std::vector<double> &tableData() const;
+
+ public slots:
+  // takes the harmonics of a table, unless it is the one synthesized
+  void setData(const std::vector<double> &data);
+
+ signals:
+  void dataChanged();
+
+ private:
+  void synthesize();
+
+  struct Impl;
+  std::unique_ptr<Impl> P;
+};
@@ -0,0 +1,75 @@
+#include "harmonic-spectrum.h"
+#include "math-fft.h"
+#include <algorithm>
+#include <cmath>
+
+typedef std::complex<double> cpx;
+
+HarmonicSpectrum::HarmonicSpectrum(unsigned harmonics)
+  : maxHarmonics_(harmonics) {
+}
+
+void HarmonicSpectrum::reset(const double *data, unsigned size) {
+  if (size != size_) {
+    size_ = size;
+    twiddles_.resize(size);
+    for (unsigned j = 0; j < size; ++j)
+      twiddles_[j] = std::polar(1.0, -2.0 * M_PI * j / size);
+  }
+
+  if (size == 0) {
+    bins_.clear();
+    return;
+  }
+
+  std::vector<cpx> spectrum(size / 2 + 1);
+  real_fft(data, size, spectrum.data());
+  unsigned count = std::min(maxHarmonics_, size / 2) + 1;
+  bins_.assign(spectrum.begin(), spectrum.begin() + count);
+}
+
+void HarmonicSpectrum::update(unsigned index, double before, double after) {
+  double delta = after - before;
+  if (delta == 0 || index >= size_)
+    return;
+
+  // X[k] += delta e^(-2 pi i k index / size), the exponent taken modulo size
+  const unsigned count = bins_.size();
+  const cpx *twiddles = twiddles_.data();
+  cpx *bins = bins_.data();
+  unsigned j = 0;
+  for (unsigned k = 0; k < count; ++k) {
+    const cpx &w = twiddles[j];
+    bins[k] = cpx(bins[k].real() + delta * w.real(),
+                  bins[k].imag() + delta * w.imag());
+    j += index;
+    if (j >= size_)
+      j -= size_;
+  }
+}
+
+double HarmonicSpectrum::amplitude(unsigned k) const {
+  double scale = (k == 0 || 2 * k == size_) ? 1.0 : 2.0;
+  return scale * std::abs(bins_[k]) / size_;
+}
+
+double HarmonicSpectrum::phase(unsigned k) const {
+  return std::arg(bins_[k]);
+}
+
+void synthesize_harmonics(double offset, const double *amplitudes, const double *phases,
+                          unsigned count, double *out, unsigned size) {
+  if (size == 0)
+    return;
+
+  // harmonics above the Nyquist frequency cannot be represented
+  count = std::min(count, size / 2);
+
+  std::vector<cpx> spectrum(size / 2 + 1);
+  spectrum[0] = offset * size;
+  for (unsigned k = 1; k <= count; ++k) {
+    double scale = (2 * k == size) ? 1.0 : 0.5;
+    spectrum[k] = std::polar(scale * amplitudes[k - 1] * size, phases[k - 1]);
+  }
+  real_ifft(spectrum.data(), size, out);
+}
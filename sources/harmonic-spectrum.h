@@ -0,0 +1,36 @@
+#pragma once
+#include <complex>
+#include <vector>
+
+// the lowest harmonics of one period, kept up to date as samples change
+//   A change of one sample updates each harmonic by one product, so a
+//   stroke of a few samples costs far less than a new transform.
+class HarmonicSpectrum {
+ public:
+  explicit HarmonicSpectrum(unsigned harmonics = 64);
+
+  // transforms the whole period
+  void reset(const double *data, unsigned size);
+  // a sample changing from `before` to `after`
+  void update(unsigned index, double before, double after);
+
+  unsigned size() const { return size_; }
+  unsigned harmonics() const { return bins_.empty() ? 0 : bins_.size() - 1; }
+
+  // the harmonic `k` as amplitude and phase of a cosine, k = 0 for offset
+  double amplitude(unsigned k) const;
+  double phase(unsigned k) const;
+  const std::complex<double> &bin(unsigned k) const { return bins_[k]; }
+
+ private:
+  unsigned maxHarmonics_ {};
+  unsigned size_ {};
+  std::vector<std::complex<double>> bins_;
+  // e^(-2 pi i j / size) for j in [0, size)
+  std::vector<std::complex<double>> twiddles_;
+};
+
+// one period of the sum of cosines of the given amplitudes and phases,
+// harmonics 1 to count above the offset, by an inverse transform
+void synthesize_harmonics(double offset, const double *amplitudes, const double *phases,
+                          unsigned count, double *out, unsigned size);
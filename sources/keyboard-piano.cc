@@ -0,0 +1,63 @@
+#include "keyboard-piano.h"
+#include <QKeyEvent>
+
+KeyboardPiano::KeyboardPiano(QObject *parent)
+  : QObject(parent) {
+}
+
+bool KeyboardPiano::eventFilter(QObject *watched, QEvent *event) {
+  switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease: {
+      QKeyEvent *keyevent = static_cast<QKeyEvent *>(event);
+      if (keyevent->modifiers() & ~(Qt::ShiftModifier|Qt::KeypadModifier))
+        break;
+      int note = keyToNote(keyevent->key());
+      if (note < 0)
+        break;
+      if (!keyevent->isAutoRepeat()) {
+        if (event->type() == QEvent::KeyPress) {
+          pressed_.insert(note);
+          emit noteOn(note);
+        } else if (pressed_.remove(note))
+          emit noteOff(note);
+      }
+      return true;
+    }
+    case QEvent::WindowDeactivate:
+      // key releases would go to another window
+      releaseAll();
+      break;
+    default:
+      break;
+  }
+
+  return QObject::eventFilter(watched, event);
+}
+
+int KeyboardPiano::keyToNote(int key) {
+  static const int lower[] = {
+    Qt::Key_Z, Qt::Key_S, Qt::Key_X, Qt::Key_D, Qt::Key_C, Qt::Key_V,
+    Qt::Key_G, Qt::Key_B, Qt::Key_H, Qt::Key_N, Qt::Key_J, Qt::Key_M,
+    Qt::Key_Comma, Qt::Key_L, Qt::Key_Period, Qt::Key_Semicolon, Qt::Key_Slash };
+  static const int upper[] = {
+    Qt::Key_Q, Qt::Key_2, Qt::Key_W, Qt::Key_3, Qt::Key_E, Qt::Key_R,
+    Qt::Key_5, Qt::Key_T, Qt::Key_6, Qt::Key_Y, Qt::Key_7, Qt::Key_U,
+    Qt::Key_I, Qt::Key_9, Qt::Key_O, Qt::Key_0, Qt::Key_P };
+
+  for (unsigned i = 0; i < sizeof(upper) / sizeof(upper[0]); ++i) {
+    if (key == upper[i])
+      return 60 + i;
+  }
+  for (unsigned i = 0; i < sizeof(lower) / sizeof(lower[0]); ++i) {
+    if (key == lower[i])
+      return 48 + i;
+  }
+  return -1;
+}
+
+void KeyboardPiano::releaseAll() {
+  for (int note : pressed_)
+    emit noteOff(note);
+  pressed_.clear();
+}
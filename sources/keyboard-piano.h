@@ -0,0 +1,23 @@
+#pragma once
+#include <QObject>
+#include <QSet>
+
+// plays notes from the computer keyboard, as an event filter
+//   two rows of keys, from C3 on the lower row and from C4 on the upper
+class KeyboardPiano : public QObject {
+  Q_OBJECT;
+ public:
+  explicit KeyboardPiano(QObject *parent = nullptr);
+
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+ signals:
+  void noteOn(int note);
+  void noteOff(int note);
+
+ private:
+  static int keyToNote(int key);
+  void releaseAll();
+
+  QSet<int> pressed_;
+};
@@ -1,36 +1,78 @@
 #include "main.h"
 #include "dot-editor-widget.h"
 #include "wave-generator.h"
+#include "wave-render.h"
 #include "wave-io.h"
+#include "math-dsp.h"
 #include "wave-io-dialog.h"
 #include "new-wave-editor.h"
+#include "keyboard-piano.h"
+#include "audio-settings-dialog.h"
+#include "render-dialog.h"
+#include "offline-render.h"
+#include "wave-table.h"
+#include "riff-wave.h"
+#include "spectrum-view.h"
+#include "harmonic-editor.h"
+#include "batch-convert.h"
 #include <QApplication>
 #include <QMainWindow>
 #include <QMenuBar>
 #include <QToolBar>
+#include <QHBoxLayout>
+#include <QStackedWidget>
 #include <QDoubleSpinBox>
+#include <QSlider>
+#include <QSignalBlocker>
+#include <QComboBox>
 #include <QLabel>
 #include <QStatusBar>
+#include <QTimer>
 #include <QAudioOutput>
+#include <QSysInfo>
 #include <QFile>
 #include <QDebug>
 #include <boost/scope_exit.hpp>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
 #include <cmath>
 
 int dotsize = 1;
 int gridwidth = 1024;
 int gridheight = 512;
 
+unsigned audio_period = 256;
+unsigned audio_periods = 3;
+
 int main(int argc, char *argv[]) {
+  // batch mode, without GUI or audio
+  if (argc > 1 && !strcmp(argv[1], "convert"))
+    return batch_convert_main(argc - 1, argv + 1);
+
   QApplication app(argc, argv);
   app.setApplicationName("Dessiner un son");
 
   prepare_audio();
   prepare_gui();
 
-  return app.exec();
+  int ret = app.exec();
+
+  ::audio_out->stop();
+  ::wave_generator->stop();
+
+  // the counters of the audio path, to a file if asked
+  if (const char *path = getenv("DESSINER_AUDIO_STATS")) {
+    std::ofstream out(path);
+    write_audio_stats(::wave_generator->stats().snapshot(),
+                      ::wave_generator->sampleRate(), out);
+    if (!out.flush())
+      std::cerr << "cannot write audio statistics to " << path << "\n";
+  }
+
+  return ret;
 }
 
 void prepare_gui() {
@@ -44,16 +86,35 @@ void prepare_gui() {
   actOpen->setShortcut(QKeySequence("Ctrl+O"));
   QAction *actSave = fileMenu->addAction(QIcon::fromTheme("document-save"), "&Save");
   actSave->setShortcut(QKeySequence("Ctrl+S"));
+  QAction *actRender = fileMenu->addAction(QIcon::fromTheme("media-record"), "&Render to WAV...");
+  actRender->setShortcut(QKeySequence("Ctrl+R"));
+  QMenu *audioMenu = mb->addMenu("Audio");
+  QAction *actAudioSettings = audioMenu->addAction(QIcon::fromTheme("configure"), "&Settings...");
 
   QToolBar *tb = new QToolBar;
   win->addToolBar(tb);
 
-  QAction *actSmooth = tb->addAction("Smooth");
-  QDoubleSpinBox *valSmooth = new QDoubleSpinBox;
-  valSmooth->setRange(0.05, 1);
-  valSmooth->setSingleStep(0.05);
-  valSmooth->setValue(0.8);
-  tb->addWidget(valSmooth);
+  tb->addWidget(new QLabel("Filter"));
+  QComboBox *selFilter = new QComboBox;
+  for (const char *name : TABLE_FILTER_NAMES)
+    selFilter->addItem(name);
+  tb->addWidget(selFilter);
+  QSlider *sldFilter = new QSlider(Qt::Horizontal);
+  sldFilter->setRange(0, 1000);
+  sldFilter->setValue(1000);
+  sldFilter->setToolTip("Cutoff");
+  sldFilter->setMaximumWidth(150);
+  tb->addWidget(sldFilter);
+  tb->addWidget(new QLabel("Warp"));
+  QSlider *sldWarp = new QSlider(Qt::Horizontal);
+  sldWarp->setRange(-100, 100);
+  sldWarp->setValue(0);
+  sldWarp->setToolTip("Phase distortion");
+  sldWarp->setMaximumWidth(150);
+  tb->addWidget(sldWarp);
+  QAction *actFilterApply = tb->addAction("Apply");
+  QAction *actFilterCancel = tb->addAction("Cancel");
+  actFilterCancel->setShortcut(QKeySequence(Qt::Key_Escape));
   tb->addSeparator();
 
   QAction *actWindow = tb->addAction("Window");
@@ -89,6 +150,32 @@ void prepare_gui() {
   valSoundFreq->setSingleStep(10.0);
   valSoundFreq->setValue(220.0);
   tb->addWidget(valSoundFreq);
+  QComboBox *selSoundInterp = new QComboBox;
+  for (const char *name : INTERPOLATION_QUALITY_NAMES)
+    selSoundInterp->addItem(name);
+  selSoundInterp->setCurrentIndex(InterpHermite);
+  tb->addWidget(selSoundInterp);
+  tb->addSeparator();
+
+  tb->addWidget(new QLabel("Frames"));
+  QSpinBox *valFrameCount = new QSpinBox;
+  valFrameCount->setRange(1, 256);
+  valFrameCount->setToolTip("Number of frames");
+  tb->addWidget(valFrameCount);
+  QSpinBox *valFrame = new QSpinBox;
+  valFrame->setRange(0, 0);
+  valFrame->setToolTip("Frame to edit");
+  tb->addWidget(valFrame);
+  QSlider *sldMorph = new QSlider(Qt::Horizontal);
+  sldMorph->setRange(0, 1000);
+  sldMorph->setToolTip("Morph position");
+  sldMorph->setMaximumWidth(150);
+  tb->addWidget(sldMorph);
+  tb->addSeparator();
+
+  QAction *actHarmonics = tb->addAction("Harmonics");
+  actHarmonics->setCheckable(true);
+  actHarmonics->setToolTip("Draw the amplitudes and phases of the harmonics");
   tb->addSeparator();
 
   BasicDotEditorWidget *editor;
@@ -97,28 +184,102 @@ void prepare_gui() {
   else
     editor = new CompactDotEditorWidget(gridwidth, gridheight);
   editor->initialize();
-  win->setCentralWidget(editor);
+
+  SpectrumView *spectrum = new SpectrumView;
+  spectrum->setMinimumSize(spectrum->sizeHint());
+  spectrum->setData(editor->dotData());
+  HarmonicEditor *harmonics = new HarmonicEditor(gridwidth);
+
+  // beside the editor, the spectrum or the harmonics being drawn
+  QStackedWidget *sidePanel = new QStackedWidget;
+  sidePanel->addWidget(spectrum);
+  sidePanel->addWidget(harmonics);
+  auto followData = [editor, spectrum, harmonics, actHarmonics]() {
+    if (actHarmonics->isChecked())
+      harmonics->setData(editor->dotData());
+    else
+      spectrum->setData(editor->dotData());
+  };
+
+  QWidget *central = new QWidget;
+  QHBoxLayout *centralLayout = new QHBoxLayout;
+  central->setLayout(centralLayout);
+  centralLayout->addWidget(editor);
+  centralLayout->addWidget(sidePanel);
+  win->setCentralWidget(central);
 
   QStatusBar *statusBar = new QStatusBar;
   win->setStatusBar(statusBar);
+  QLabel *lblAudioStats = new QLabel;
+  statusBar->addPermanentWidget(lblAudioStats);
+  QLabel *lblLatency = new QLabel;
+  statusBar->addPermanentWidget(lblLatency);
+
+  QTimer *statusTimer = new QTimer(win);
+  statusTimer->start(250);
 
   QObject::connect(actSave, &QAction::triggered,
                    editor, [editor]() { save_wavedata(editor->dotData()); });
+  QObject::connect(actRender, &QAction::triggered,
+                   editor, [editor]() { render_wavedata(editor->dotData()); });
   QObject::connect(actOpen, &QAction::triggered,
                    editor, [editor]() {
                      std::vector<double> &dotdata = editor->dotData();
                      if (load_wavedata(dotdata))
-                       editor->update();
+                       editor->notifyDataChanged();
                    });
   QObject::connect(actGenerate, &QAction::triggered,
                    editor, [editor]() {
                                std::vector<double> &dotdata = editor->dotData();
                                if (gen_wavedata(dotdata))
-                                   editor->update();
+                                   editor->notifyDataChanged();
                            });
 
-  QObject::connect(actSmooth, &QAction::triggered,
-                   editor, [editor, valSmooth]() { editor->smooth(valSmooth->value()); });
+  // previews from the slider, each from the data before the preview
+  auto previewFilter = [editor, followData, selFilter, sldFilter]() {
+    double top = std::log2(gridwidth / 2.0);
+    double cutoff = std::exp2(top * sldFilter->value() / sldFilter->maximum());
+    editor->previewFilter(TableFilter(selFilter->currentIndex()), cutoff);
+    followData();
+  };
+  auto previewWarp = [editor, followData, sldWarp]() {
+    editor->previewPhaseWarp(sldWarp->value() * 1e-2);
+    followData();
+  };
+  auto resetFilter = [sldFilter, sldWarp]() {
+    QSignalBlocker block(sldFilter);
+    QSignalBlocker blockWarp(sldWarp);
+    sldFilter->setValue(sldFilter->maximum());
+    sldWarp->setValue(0);
+  };
+  // one preview at a time, the other slider going back to its rest
+  QObject::connect(sldFilter, &QSlider::valueChanged, editor, [sldWarp, previewFilter]() {
+                     QSignalBlocker block(sldWarp);
+                     sldWarp->setValue(0);
+                     previewFilter();
+                   });
+  QObject::connect(sldWarp, &QSlider::valueChanged, editor, [sldFilter, previewWarp]() {
+                     QSignalBlocker block(sldFilter);
+                     sldFilter->setValue(sldFilter->maximum());
+                     previewWarp();
+                   });
+  QObject::connect(selFilter, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+                   editor, [editor, sldWarp, previewFilter]() {
+                     if (editor->inPreview() && sldWarp->value() == 0)
+                       previewFilter();
+                   });
+  QObject::connect(actFilterApply, &QAction::triggered,
+                   editor, [editor, resetFilter]() {
+                     if (editor->inPreview())
+                       editor->notifyDataChanged();
+                     resetFilter();
+                   });
+  QObject::connect(actFilterCancel, &QAction::triggered,
+                   editor, [editor, followData, resetFilter]() {
+                     editor->cancelPreview();
+                     followData();
+                     resetFilter();
+                   });
 
   QObject::connect(actWindow, &QAction::triggered,
                    editor, [editor, valWindow]() { editor->window(valWindow->value()); });
@@ -142,6 +303,46 @@ void prepare_gui() {
   QObject::connect(actInvertR, &QAction::triggered,
                    editor, [editor]() { editor->invert(DotEditorWidget::RightSide); });
 
+  QObject::connect(actAudioSettings, &QAction::triggered,
+                   win, [win]() {
+                     AudioSettingsDialog dlg(win);
+                     dlg.setPeriod(::audio_period);
+                     dlg.setPeriods(::audio_periods);
+                     if (dlg.exec() != AudioSettingsDialog::Accepted)
+                       return;
+                     ::audio_period = dlg.period();
+                     ::audio_periods = dlg.periods();
+                     configure_audio();
+                   });
+
+  QObject::connect(statusTimer, &QTimer::timeout,
+                   lblLatency, [lblLatency]() {
+                     QString text = "Audio stopped";
+                     if (::audio_out->state() != QAudio::StoppedState)
+                       text = QString("Latency %0 ms").arg(1e3 * output_latency(), 0, 'f', 1);
+                     lblLatency->setText(text);
+                   });
+
+  // load and read times over the last interval, underruns since start
+  std::shared_ptr<AudioStats::Snapshot> lastStats(
+    new AudioStats::Snapshot(::wave_generator->stats().snapshot()));
+  QObject::connect(statusTimer, &QTimer::timeout,
+                   lblAudioStats, [lblAudioStats, lastStats]() {
+                     AudioStats::Snapshot stats = ::wave_generator->stats().snapshot();
+                     const AudioStats::Snapshot &last = *lastStats;
+                     double load = render_load(last, stats, ::wave_generator->sampleRate());
+                     uint64_t reads = stats.reads - last.reads;
+                     double read_mean = reads ? 1e-3 * (stats.readNanos - last.readNanos) / reads : 0;
+                     QString text = QString("Load %0%  Read %1 us (max %2)  Underruns %3/%4")
+                       .arg(1e2 * load, 0, 'f', 1)
+                       .arg(read_mean, 0, 'f', 1)
+                       .arg(1e-3 * stats.readMaxNanos, 0, 'f', 0)
+                       .arg(stats.ringUnderruns).arg(stats.deviceUnderruns);
+                     lblAudioStats->setText(text);
+                     lblAudioStats->setToolTip("Underruns of the render ring / of the device");
+                     *lastStats = stats;
+                   });
+
   QObject::connect(editor, &DotEditorWidget::hoveredGridCoord,
                    statusBar, [statusBar](QPoint gridpoint) {
                      QString status = QString("X %0 Y %1")
@@ -149,17 +350,73 @@ void prepare_gui() {
                      statusBar->showMessage(status);
                    });
 
+  // the spectrum follows the strokes, by the few samples they change
+  QObject::connect(editor, &BasicDotEditorWidget::dataChanged,
+                   sidePanel, followData);
+
+  // the harmonics drawn replace the table, which goes on to playback
+  QObject::connect(harmonics, &HarmonicEditor::dataChanged,
+                   editor, [editor, harmonics]() {
+                     editor->dotData() = harmonics->tableData();
+                     editor->notifyDataChanged();
+                   });
+  QObject::connect(actHarmonics, &QAction::toggled,
+                   sidePanel, [sidePanel, spectrum, harmonics, followData](bool checked) {
+                     sidePanel->setCurrentWidget(checked ? static_cast<QWidget *>(harmonics) : spectrum);
+                     followData();
+                   });
+
+  ::wave_generator->setWavetable(editor->dotData());
+  QObject::connect(editor, &BasicDotEditorWidget::dataChanged,
+                   ::wave_generator, [editor, valFrame]() {
+                     ::wave_generator->setWavetable(editor->dotData(), valFrame->value());
+                   });
+
+  auto updateMorph = [valFrameCount, sldMorph]() {
+    double position = sldMorph->value() / double(sldMorph->maximum());
+    ::wave_generator->setMorph(position * (valFrameCount->value() - 1));
+  };
+  QObject::connect(valFrameCount, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+                   ::wave_generator, [valFrame, updateMorph](int value) {
+                     ::wave_generator->setFrameCount(value);
+                     valFrame->setMaximum(value - 1);
+                     updateMorph();
+                   });
+  QObject::connect(valFrame, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+                   editor, [editor, followData](int value) {
+                     editor->cancelPreview();
+                     editor->dotData() = ::wave_generator->frameData(value);
+                     editor->update();
+                     followData();
+                   });
+  QObject::connect(sldMorph, &QSlider::valueChanged,
+                   ::wave_generator, updateMorph);
+
   QObject::connect(actSoundPlay, &QAction::triggered,
-                   ::audio_out, [editor, valSoundFreq]() {
-                     ::audio_out->stop();
-                     ::wave_generator->setWavetable(editor->dotData());
+                   ::audio_out, [valSoundFreq]() {
                      ::wave_generator->setFrequency(valSoundFreq->value());
-                     ::audio_out->start(::wave_generator);
+                     ::wave_generator->play();
+                     start_audio();
                    });
   QObject::connect(actSoundStop, &QAction::triggered,
-                   ::audio_out, []() { ::audio_out->stop(); });
+                   ::audio_out, []() {
+                     ::wave_generator->allNotesOff();
+                     ::audio_out->stop();
+                   });
   QObject::connect(valSoundFreq, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
                    ::audio_out, [](double value) { ::wave_generator->setFrequency(value); });
+  QObject::connect(selSoundInterp, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+                   ::audio_out, [](int index) { ::wave_generator->setInterpolation(InterpolationQuality(index)); });
+
+  KeyboardPiano *piano = new KeyboardPiano(win);
+  win->installEventFilter(piano);
+  QObject::connect(piano, &KeyboardPiano::noteOn,
+                   ::audio_out, [](int note) {
+                     ::wave_generator->noteOn(note);
+                     start_audio();
+                   });
+  QObject::connect(piano, &KeyboardPiano::noteOff,
+                   ::audio_out, [](int note) { ::wave_generator->noteOff(note); });
 
   win->show();
 }
@@ -168,23 +425,100 @@ QAudioFormat audio_format;
 QAudioOutput *audio_out;
 WaveGenerator *wave_generator;
 
+static QAudioFormat choose_audio_format(const QAudioDeviceInfo &info) {
+  QAudioFormat preferred = info.preferredFormat();
+  preferred.setCodec("audio/pcm");
+  preferred.setByteOrder(QAudioFormat::Endian(QSysInfo::ByteOrder));
+  preferred.setChannelCount((preferred.channelCount() > 1) ? 2 : 1);
+
+  // the device's own sample type if there is a reader for it, otherwise
+  // the first of ours which the device takes without conversion
+  struct SampleType { QAudioFormat::SampleType type; int size; };
+  static const SampleType types[] = {
+    {QAudioFormat::Float, 32},
+    {QAudioFormat::SignedInt, 16},
+    {QAudioFormat::SignedInt, 32},
+  };
+
+  for (const SampleType &t : types) {
+    if (preferred.sampleType() == t.type && preferred.sampleSize() == t.size &&
+        info.isFormatSupported(preferred))
+      return preferred;
+  }
+
+  for (int channels : {preferred.channelCount(), 1}) {
+    for (const SampleType &t : types) {
+      QAudioFormat format = preferred;
+      format.setChannelCount(channels);
+      format.setSampleType(t.type);
+      format.setSampleSize(t.size);
+      if (info.isFormatSupported(format))
+        return format;
+    }
+  }
+
+  // let Qt convert as a last resort
+  QAudioFormat format = preferred;
+  format.setChannelCount(1);
+  format.setSampleType(QAudioFormat::Float);
+  format.setSampleSize(32);
+  return format;
+}
+
 void prepare_audio() {
   QAudioDeviceInfo info = QAudioDeviceInfo::defaultOutputDevice();
-  audio_format = info.preferredFormat();
-  audio_format.setChannelCount(1);
-  audio_format.setSampleSize(8 * sizeof(float));
-  audio_format.setCodec("audio/pcm");
-  audio_format.setSampleType(QAudioFormat::Float);
+  audio_format = choose_audio_format(info);
 
   audio_out = new QAudioOutput(info, audio_format);
   std::cerr << "audio sampling rate is " << audio_format.sampleRate() << "\n";
-  std::cerr << "audio buffer size is " << ::audio_out->bufferSize() << "\n";
+  std::cerr << "audio format is " << audio_format.channelCount() << " channels of "
+            << audio_format.sampleSize() << "-bit "
+            << ((audio_format.sampleType() == QAudioFormat::Float) ? "float" : "integer") << "\n";
 
   double attenuation = -20.0;
   audio_out->setVolume(std::pow(10.0, attenuation * 0.05));
 
   ::wave_generator = new WaveGenerator(audio_out);
-  ::wave_generator->start(::audio_out->bufferSize(), ::audio_format.sampleRate());
+  if (!::wave_generator->setOutputFormat(audio_format))
+    std::cerr << "audio format is not supported\n";
+
+  QObject::connect(audio_out, &QAudioOutput::stateChanged,
+                   ::wave_generator, [](QAudio::State state) {
+                     AudioStats &stats = ::wave_generator->stats();
+                     QAudio::Error error = ::audio_out->error();
+                     if (error == QAudio::UnderrunError && state == QAudio::IdleState)
+                       stats.recordDeviceUnderrun();
+                     else if (error != QAudio::NoError && error != QAudio::UnderrunError)
+                       stats.recordDeviceError();
+                   });
+  configure_audio();
+}
+
+void configure_audio() {
+  bool active = ::audio_out->state() != QAudio::StoppedState;
+  ::audio_out->stop();
+
+  // as much again in the device as in the ring of the render thread
+  ::wave_generator->start(::audio_format.sampleRate(), ::audio_period, ::audio_periods);
+  ::audio_out->setBufferSize(::audio_period * ::audio_periods * ::audio_format.bytesPerFrame());
+  std::cerr << "audio period is " << ::audio_period << " x " << ::audio_periods << "\n";
+
+  if (active)
+    ::audio_out->start(::wave_generator);
+}
+
+double output_latency() {
+  // frames rendered ahead, in the ring and in the device buffer
+  int frame_bytes = ::audio_format.bytesPerFrame();
+  int device_frames = (frame_bytes > 0) ?
+    (::audio_out->bufferSize() - ::audio_out->bytesFree()) / frame_bytes : 0;
+  double frames = ::wave_generator->bufferedFrames() + device_frames;
+  return frames / ::audio_format.sampleRate();
+}
+
+void start_audio() {
+  if (::audio_out->state() == QAudio::StoppedState)
+    ::audio_out->start(::wave_generator);
 }
 
 bool save_wavedata(const std::vector<double> &wavedata) {
@@ -201,10 +535,40 @@ bool save_wavedata(const std::vector<double> &wavedata) {
   int outsize = dlg->waveOutputSize();
   WaveFormat outfmt = WaveFormat(dlg->waveOutputFormat());
   WaveDataType outtype = WaveDataType(dlg->waveOutputDataType());
+  ResampleQuality quality = ResampleQuality(dlg->waveResampleQuality());
 
   std::vector<float> fdata(wavedata.begin(), wavedata.end());
   std::ofstream out(outfilename.toStdString(), std::ios::binary);
-  write_wave(fdata.data(), fdata.size(), outsize, outfmt, outtype, out);
+  write_wave(fdata.data(), fdata.size(), outsize, outfmt, outtype, out, quality);
+  out.flush();
+
+  if (!out) {
+    QFile::remove(outfilename);
+    return false;
+  }
+
+  return true;
+}
+
+bool render_wavedata(const std::vector<double> &wavedata) {
+  RenderDialog *dlg = new RenderDialog;
+  BOOST_SCOPE_EXIT(dlg) { delete dlg; } BOOST_SCOPE_EXIT_END;
+
+  if (dlg->exec() != RenderDialog::Accepted)
+    return true;
+
+  QString outfilename = dlg->waveFilename();
+  if (outfilename.isEmpty())
+    return true;
+
+  OfflineRender settings = dlg->renderSettings();
+  RiffSampleFormat outfmt = RiffSampleFormat(dlg->renderSampleFormat());
+
+  MipmapWavetable table(wavedata.data(), wavedata.size());
+  std::vector<float> samples = render_offline(table, settings);
+
+  std::ofstream out(outfilename.toStdString(), std::ios::binary);
+  write_riff_wave(samples.data(), samples.size(), 1, settings.sampleRate, outfmt, out);
   out.flush();
 
   if (!out) {
@@ -228,10 +592,13 @@ bool load_wavedata(std::vector<double> &wavedata) {
 
   WaveFormat infmt = WaveFormat(dlg->waveInputFormat());
   unsigned inchannel = dlg->waveInputChannel();
+  unsigned inframelength = dlg->waveFrameLength();
+  unsigned inframe = dlg->waveFrame();
+  ResampleQuality quality = ResampleQuality(dlg->waveResampleQuality());
 
-  std::ifstream in(infilename.toStdString(), std::ios::binary);
   std::vector<float> fdata(wavedata.begin(), wavedata.end());
-  if (!read_wave_from_stream(fdata.data(), fdata.size(), in, infmt, inchannel))
+  if (!read_wave_from_file(fdata.data(), fdata.size(), infilename.toStdString(), infmt, inchannel, quality,
+                           inframelength, inframe))
     return false;
 
   wavedata.assign(fdata.begin(), fdata.end());
@@ -243,23 +610,25 @@ bool gen_wavedata(std::vector<double> &wavedata)
     NewWaveEditor waveEd;
     bool update = false;
 
+    // previews while editing, exact once accepted
     auto update_dotdata =
-        [&] {
+        [&] (ResampleQuality quality) {
             std::vector<float> in_samples(waveEd.waveData(), waveEd.waveData() + waveEd.waveSize());
             std::unique_ptr<float[]> out_samples(new float[wavedata.size()]);
 
             resample(in_samples.data(), in_samples.size(),
-                     out_samples.get(), wavedata.size());
+                     out_samples.get(), wavedata.size(), quality);
 
             wavedata.assign(&out_samples[0], &out_samples[wavedata.size()]);
 
             update = true;
         };
 
-    QObject::connect(&waveEd, &NewWaveEditor::editingFinished, &waveEd, update_dotdata);
+    QObject::connect(&waveEd, &NewWaveEditor::editingFinished, &waveEd,
+                     [&] { update_dotdata(ResampleLinear); });
 
     if (waveEd.exec() == QDialog::Accepted)
-        update_dotdata();
+        update_dotdata(ResamplePeriodic);
 
     return update;
 }
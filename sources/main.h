@@ -3,6 +3,12 @@
 
 void prepare_gui();
 void prepare_audio();
+void start_audio();
+void configure_audio();
+double output_latency();
+
+extern unsigned audio_period;
+extern unsigned audio_periods;
 
 class QAudioFormat;
 extern QAudioFormat audio_format;
@@ -12,5 +18,6 @@ class WaveGenerator;
 extern WaveGenerator *wave_generator;
 
 bool save_wavedata(const std::vector<double> &wavedata);
+bool render_wavedata(const std::vector<double> &wavedata);
 bool load_wavedata(std::vector<double> &wavedata);
 bool gen_wavedata(std::vector<double> &wavedata);
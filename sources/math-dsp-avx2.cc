@@ -0,0 +1,189 @@
+#define MATH_DSP_KERNELS_IMPL
+#include "math-dsp-kernels.h"
+#include <immintrin.h>
+
+namespace {
+
+void smooth_avx2(double *data, unsigned size, double s) {
+  if (size < 2)
+    return;
+
+  // each sample reads the next, before the next is written
+  const unsigned count = size - 1;
+  const double t = 1.0 - s;
+  const __m256d vs = _mm256_set1_pd(s);
+  const __m256d vt = _mm256_set1_pd(t);
+  unsigned i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d x0 = _mm256_loadu_pd(data + i);
+    __m256d x1 = _mm256_loadu_pd(data + i + 1);
+    _mm256_storeu_pd(data + i, _mm256_add_pd(_mm256_mul_pd(x0, vs), _mm256_mul_pd(x1, vt)));
+  }
+  for (; i < count; ++i)
+    data[i] = data[i] * s + data[i + 1] * t;
+}
+
+void negate_avx2(double *data, unsigned size) {
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  unsigned i = 0;
+  for (; i + 4 <= size; i += 4)
+    _mm256_storeu_pd(data + i, _mm256_xor_pd(_mm256_loadu_pd(data + i), sign));
+  for (; i < size; ++i)
+    data[i] = -data[i];
+}
+
+void multiply_avx2(double *data, const double *factors, unsigned size) {
+  unsigned i = 0;
+  for (; i + 4 <= size; i += 4)
+    _mm256_storeu_pd(data + i, _mm256_mul_pd(_mm256_loadu_pd(data + i), _mm256_loadu_pd(factors + i)));
+  for (; i < size; ++i)
+    data[i] *= factors[i];
+}
+
+void mirror_avx2(double *data, unsigned size, bool left_to_right) {
+  const unsigned half = size / 2;
+  const double *src = left_to_right ? data : data + size - half;
+  double *dst = left_to_right ? data + size - 1 : data + half - 1;
+  unsigned i = 0;
+  for (; i + 4 <= half; i += 4) {
+    __m256d x = _mm256_loadu_pd(src + i);
+    _mm256_storeu_pd(dst - i - 3, _mm256_permute4x64_pd(x, _MM_SHUFFLE(0, 1, 2, 3)));
+  }
+  for (; i < half; ++i)
+    dst[-int(i)] = src[i];
+}
+
+void interpolate_avx2(const float *in, unsigned n, float *out, unsigned m) {
+  // lanes step by 8 outputs, as quotient and remainder of 8*n/m,
+  // which needs the remainders to stay within signed 32 bits
+  const unsigned long long step = 8ull * n;
+  unsigned i = 0;
+  if (m < (1u << 30) && step < (1u << 30)) {
+    const __m256i vq = _mm256_set1_epi32(int(step / m));
+    const __m256i vr = _mm256_set1_epi32(int(step % m));
+    const __m256i vm = _mm256_set1_epi32(int(m));
+    const __m256i vmlast = _mm256_set1_epi32(int(m - 1));
+    const __m256i vn = _mm256_set1_epi32(int(n));
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 fm = _mm256_set1_ps(float(m));
+    alignas(32) int32_t k0[8], r0[8];
+    for (unsigned j = 0; j < 8; ++j) {
+      k0[j] = int((unsigned long long)j * n / m);
+      r0[j] = int((unsigned long long)j * n % m);
+    }
+    __m256i index = _mm256_load_si256((const __m256i *)k0);
+    __m256i rem = _mm256_load_si256((const __m256i *)r0);
+
+    for (; i + 8 <= m; i += 8) {
+      __m256i next = _mm256_add_epi32(index, one);
+      next = _mm256_andnot_si256(_mm256_cmpeq_epi32(next, vn), next);
+      __m256 s0 = _mm256_i32gather_ps(in, index, 4);
+      __m256 s1 = _mm256_i32gather_ps(in, next, 4);
+      __m256 frac = _mm256_div_ps(_mm256_cvtepi32_ps(rem), fm);
+      _mm256_storeu_ps(out + i, _mm256_add_ps(s0, _mm256_mul_ps(frac, _mm256_sub_ps(s1, s0))));
+
+      rem = _mm256_add_epi32(rem, vr);
+      __m256i carry = _mm256_cmpgt_epi32(rem, vmlast);
+      rem = _mm256_sub_epi32(rem, _mm256_and_si256(carry, vm));
+      index = _mm256_sub_epi32(_mm256_add_epi32(index, vq), carry);
+    }
+  }
+  interpolate_rest(in, n, out, m, i);
+}
+
+void warp_avx2(const double *in, const int32_t *index, const int32_t *next,
+               const double *frac, double *out, unsigned count) {
+  // the masked gather, as the other leaves its source undefined
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+  unsigned i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i k0 = _mm_loadu_si128((const __m128i *)(index + i));
+    __m128i k1 = _mm_loadu_si128((const __m128i *)(next + i));
+    __m256d x0 = _mm256_mask_i32gather_pd(zero, in, k0, all, 8);
+    __m256d x1 = _mm256_mask_i32gather_pd(zero, in, k1, all, 8);
+    __m256d mu = _mm256_loadu_pd(frac + i);
+    _mm256_storeu_pd(out + i, _mm256_add_pd(x0, _mm256_mul_pd(mu, _mm256_sub_pd(x1, x0))));
+  }
+  warp_rest(in, index + i, next + i, frac + i, out + i, count - i);
+}
+
+void normalize_avx2(float *samples, unsigned count, float divisor) {
+  const __m256 vd = _mm256_set1_ps(divisor);
+  const __m256 lo = _mm256_set1_ps(-1.0f);
+  const __m256 hi = _mm256_set1_ps(1.0f);
+  const __m256 zero = _mm256_setzero_ps();
+  unsigned i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_div_ps(_mm256_loadu_ps(samples + i), vd);
+    // x - x is 0 only if finite
+    x = _mm256_and_ps(x, _mm256_cmp_ps(_mm256_sub_ps(x, x), zero, _CMP_EQ_OQ));
+    _mm256_storeu_ps(samples + i, _mm256_min_ps(_mm256_max_ps(x, lo), hi));
+  }
+  for (; i < count; ++i)
+    samples[i] = normalize_sample(samples[i], divisor);
+}
+
+void quantize_avx2(float *samples, unsigned count, float scale) {
+  const __m256 vs = _mm256_set1_ps(scale);
+  const __m256 lo = _mm256_set1_ps(-scale - 1.0f);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 minushalf = _mm256_set1_ps(-0.5f);
+  unsigned i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_mul_ps(_mm256_loadu_ps(samples + i), vs);
+    x = _mm256_and_ps(x, _mm256_cmp_ps(x, x, _CMP_ORD_Q));
+    x = _mm256_min_ps(_mm256_max_ps(x, lo), vs);
+    // truncated, then moved away from zero by the masks of -1
+    __m256i t = _mm256_cvttps_epi32(x);
+    __m256 d = _mm256_sub_ps(x, _mm256_cvtepi32_ps(t));
+    t = _mm256_sub_epi32(t, _mm256_castps_si256(_mm256_cmp_ps(d, half, _CMP_GE_OQ)));
+    t = _mm256_add_epi32(t, _mm256_castps_si256(_mm256_cmp_ps(d, minushalf, _CMP_LE_OQ)));
+    _mm256_storeu_ps(samples + i, _mm256_cvtepi32_ps(t));
+  }
+  for (; i < count; ++i)
+    samples[i] = quantize_sample(samples[i], scale);
+}
+
+void scan_avx2(const float *samples, unsigned count, SampleScan &scan) {
+  unsigned i = 0;
+  if (count >= 8) {
+    __m256 vmin = _mm256_set1_ps(scan.min);
+    __m256 vmax = _mm256_set1_ps(scan.max);
+    __m256 integral = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (; i + 8 <= count; i += 8) {
+      __m256 s = _mm256_loadu_ps(samples + i);
+      // the second operand if either is NaN, as the comparisons of scan_rest
+      vmin = _mm256_min_ps(s, vmin);
+      vmax = _mm256_max_ps(s, vmax);
+      __m256 t = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(s));
+      integral = _mm256_and_ps(integral, _mm256_cmp_ps(s, t, _CMP_EQ_OQ));
+    }
+    alignas(32) float lmin[8], lmax[8];
+    _mm256_store_ps(lmin, vmin);
+    _mm256_store_ps(lmax, vmax);
+    for (unsigned j = 0; j < 8; ++j) {
+      if (lmin[j] < scan.min) scan.min = lmin[j];
+      if (lmax[j] > scan.max) scan.max = lmax[j];
+    }
+    if (_mm256_movemask_ps(integral) != 0xff)
+      scan.integral = false;
+  }
+  scan_rest(samples + i, count - i, scan);
+}
+
+}  // namespace
+
+SampleKernels sample_kernels_avx2() {
+  SampleKernels k;
+  k.smooth = &smooth_avx2;
+  k.negate = &negate_avx2;
+  k.multiply = &multiply_avx2;
+  k.mirror = &mirror_avx2;
+  k.interpolate = &interpolate_avx2;
+  k.warp = &warp_avx2;
+  k.normalize = &normalize_avx2;
+  k.quantize = &quantize_avx2;
+  k.scan = &scan_avx2;
+  return k;
+}
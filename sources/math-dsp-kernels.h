@@ -0,0 +1,103 @@
+#pragma once
+#include "cpu-dispatch.h"
+#include <cstdint>
+
+// private to the DSP code: loops over samples, for each instruction set
+//   Each instruction set has its own translation unit, compiled with its
+//   own flags; the scalar parts they share are in an anonymous namespace.
+
+struct SampleScan {
+  float min;
+  float max;
+  // all within the range of int, and without fraction
+  bool integral;
+};
+
+struct SampleKernels {
+  // the editor operations, see math-dsp.h
+  void (*smooth)(double *data, unsigned size, double s);
+  void (*negate)(double *data, unsigned size);
+  void (*multiply)(double *data, const double *factors, unsigned size);
+  void (*mirror)(double *data, unsigned size, bool left_to_right);
+  // one period by linear interpolation, see resample_linear
+  void (*interpolate)(const float *in, unsigned n, float *out, unsigned m);
+  // out[i] = in[index[i]] interpolated toward in[next[i]] by frac[i]
+  void (*warp)(const double *in, const int32_t *index, const int32_t *next,
+               const double *frac, double *out, unsigned count);
+  // the conversions of wave-io, see math-dsp.h
+  void (*normalize)(float *samples, unsigned count, float divisor);
+  void (*quantize)(float *samples, unsigned count, float scale);
+  void (*scan)(const float *samples, unsigned count, SampleScan &scan);
+};
+
+// the kernels of the path in use
+const SampleKernels &sample_kernels();
+
+// the kernels of a path, for comparing them
+SampleKernels sample_kernels_for(CpuPath path);
+
+SampleKernels sample_kernels_generic();
+#if defined(DESSINER_X86_SIMD)
+SampleKernels sample_kernels_sse2();
+SampleKernels sample_kernels_avx2();
+#endif
+
+#if defined(MATH_DSP_KERNELS_IMPL)
+#include <cmath>
+namespace {
+
+// the scalar conversions, also finishing the vector loops
+inline float normalize_sample(float x, float divisor) {
+  x /= divisor;
+  if (!(x - x == 0.0f))
+    return 0.0f;
+  return (x < -1.0f) ? -1.0f : (x > 1.0f) ? 1.0f : x;
+}
+
+// rounding half away from zero, as lround, after clamping
+inline float quantize_sample(float x, float scale) {
+  x *= scale;
+  if (x != x)
+    return 0.0f;
+  x = (x < -scale - 1.0f) ? -scale - 1.0f : (x > scale) ? scale : x;
+  float t = float(int(x));
+  float d = x - t;
+  return (d >= 0.5f) ? t + 1.0f : (d <= -0.5f) ? t - 1.0f : t;
+}
+
+inline bool integral_sample(float x) {
+  return x >= -2147483648.0f && x < 2147483648.0f && x == float(int(x));
+}
+
+inline void scan_rest(const float *samples, unsigned count, SampleScan &scan) {
+  for (unsigned i = 0; i < count; ++i) {
+    float s = samples[i];
+    if (s < scan.min) scan.min = s;
+    if (s > scan.max) scan.max = s;
+    if (!integral_sample(s)) scan.integral = false;
+  }
+}
+
+inline void warp_rest(const double *in, const int32_t *index, const int32_t *next,
+                      const double *frac, double *out, unsigned count) {
+  for (unsigned i = 0; i < count; ++i) {
+    double x0 = in[index[i]];
+    out[i] = x0 + frac[i] * (in[next[i]] - x0);
+  }
+}
+
+// output samples `i` to `m` of the linear interpolation
+//   positions are i*n/m as quotient and remainder, exact for any sizes
+inline void interpolate_rest(const float *in, unsigned n, float *out, unsigned m, unsigned i) {
+  unsigned long long position = (unsigned long long)i * n;
+  for (; i < m; ++i, position += n) {
+    unsigned index = position / m;
+    float frac = float(position % m) / m;
+    float s0 = in[index];
+    float s1 = in[(index + 1 < n) ? index + 1 : 0];
+    out[i] = s0 + frac * (s1 - s0);
+  }
+}
+
+}  // namespace
+#endif
@@ -0,0 +1,182 @@
+#define MATH_DSP_KERNELS_IMPL
+#include "math-dsp-kernels.h"
+#include <emmintrin.h>
+
+namespace {
+
+void smooth_sse2(double *data, unsigned size, double s) {
+  if (size < 2)
+    return;
+
+  // each sample reads the next, before the next is written
+  const unsigned count = size - 1;
+  const double t = 1.0 - s;
+  const __m128d vs = _mm_set1_pd(s);
+  const __m128d vt = _mm_set1_pd(t);
+  unsigned i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d x0 = _mm_loadu_pd(data + i);
+    __m128d x1 = _mm_loadu_pd(data + i + 1);
+    _mm_storeu_pd(data + i, _mm_add_pd(_mm_mul_pd(x0, vs), _mm_mul_pd(x1, vt)));
+  }
+  for (; i < count; ++i)
+    data[i] = data[i] * s + data[i + 1] * t;
+}
+
+void negate_sse2(double *data, unsigned size) {
+  const __m128d sign = _mm_set1_pd(-0.0);
+  unsigned i = 0;
+  for (; i + 2 <= size; i += 2)
+    _mm_storeu_pd(data + i, _mm_xor_pd(_mm_loadu_pd(data + i), sign));
+  for (; i < size; ++i)
+    data[i] = -data[i];
+}
+
+void multiply_sse2(double *data, const double *factors, unsigned size) {
+  unsigned i = 0;
+  for (; i + 2 <= size; i += 2)
+    _mm_storeu_pd(data + i, _mm_mul_pd(_mm_loadu_pd(data + i), _mm_loadu_pd(factors + i)));
+  for (; i < size; ++i)
+    data[i] *= factors[i];
+}
+
+void mirror_sse2(double *data, unsigned size, bool left_to_right) {
+  const unsigned half = size / 2;
+  const double *src = left_to_right ? data : data + size - half;
+  double *dst = left_to_right ? data + size - 1 : data + half - 1;
+  unsigned i = 0;
+  for (; i + 2 <= half; i += 2) {
+    __m128d x = _mm_loadu_pd(src + i);
+    _mm_storeu_pd(dst - i - 1, _mm_shuffle_pd(x, x, 1));
+  }
+  for (; i < half; ++i)
+    dst[-int(i)] = src[i];
+}
+
+void interpolate_sse2(const float *in, unsigned n, float *out, unsigned m) {
+  // lanes step by 4 outputs, as quotient and remainder of 4*n/m,
+  // which needs the remainders to stay within signed 32 bits
+  const unsigned long long step = 4ull * n;
+  unsigned i = 0;
+  if (m < (1u << 30) && step < (1u << 30)) {
+    const __m128i vq = _mm_set1_epi32(int(step / m));
+    const __m128i vr = _mm_set1_epi32(int(step % m));
+    const __m128i vm = _mm_set1_epi32(int(m));
+    const __m128i vmlast = _mm_set1_epi32(int(m - 1));
+    const __m128i vn = _mm_set1_epi32(int(n));
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128 fm = _mm_set1_ps(float(m));
+    __m128i index = _mm_setr_epi32(0, int(n / m), int(2ull * n / m), int(3ull * n / m));
+    __m128i rem = _mm_setr_epi32(0, int(n % m), int(2ull * n % m), int(3ull * n % m));
+
+    for (; i + 4 <= m; i += 4) {
+      __m128i next = _mm_add_epi32(index, one);
+      next = _mm_andnot_si128(_mm_cmpeq_epi32(next, vn), next);
+      alignas(16) int32_t k0[4], k1[4];
+      _mm_store_si128((__m128i *)k0, index);
+      _mm_store_si128((__m128i *)k1, next);
+      __m128 s0 = _mm_setr_ps(in[k0[0]], in[k0[1]], in[k0[2]], in[k0[3]]);
+      __m128 s1 = _mm_setr_ps(in[k1[0]], in[k1[1]], in[k1[2]], in[k1[3]]);
+      __m128 frac = _mm_div_ps(_mm_cvtepi32_ps(rem), fm);
+      _mm_storeu_ps(out + i, _mm_add_ps(s0, _mm_mul_ps(frac, _mm_sub_ps(s1, s0))));
+
+      rem = _mm_add_epi32(rem, vr);
+      __m128i carry = _mm_cmpgt_epi32(rem, vmlast);
+      rem = _mm_sub_epi32(rem, _mm_and_si128(carry, vm));
+      index = _mm_sub_epi32(_mm_add_epi32(index, vq), carry);
+    }
+  }
+  interpolate_rest(in, n, out, m, i);
+}
+
+void warp_sse2(const double *in, const int32_t *index, const int32_t *next,
+               const double *frac, double *out, unsigned count) {
+  unsigned i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d x0 = _mm_setr_pd(in[index[i]], in[index[i + 1]]);
+    __m128d x1 = _mm_setr_pd(in[next[i]], in[next[i + 1]]);
+    __m128d mu = _mm_loadu_pd(frac + i);
+    _mm_storeu_pd(out + i, _mm_add_pd(x0, _mm_mul_pd(mu, _mm_sub_pd(x1, x0))));
+  }
+  warp_rest(in, index + i, next + i, frac + i, out + i, count - i);
+}
+
+void normalize_sse2(float *samples, unsigned count, float divisor) {
+  const __m128 vd = _mm_set1_ps(divisor);
+  const __m128 lo = _mm_set1_ps(-1.0f);
+  const __m128 hi = _mm_set1_ps(1.0f);
+  const __m128 zero = _mm_setzero_ps();
+  unsigned i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_div_ps(_mm_loadu_ps(samples + i), vd);
+    // x - x is 0 only if finite
+    x = _mm_and_ps(x, _mm_cmpeq_ps(_mm_sub_ps(x, x), zero));
+    _mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(x, lo), hi));
+  }
+  for (; i < count; ++i)
+    samples[i] = normalize_sample(samples[i], divisor);
+}
+
+void quantize_sse2(float *samples, unsigned count, float scale) {
+  const __m128 vs = _mm_set1_ps(scale);
+  const __m128 lo = _mm_set1_ps(-scale - 1.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 minushalf = _mm_set1_ps(-0.5f);
+  unsigned i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_mul_ps(_mm_loadu_ps(samples + i), vs);
+    x = _mm_and_ps(x, _mm_cmpord_ps(x, x));
+    x = _mm_min_ps(_mm_max_ps(x, lo), vs);
+    // truncated, then moved away from zero by the masks of -1
+    __m128i t = _mm_cvttps_epi32(x);
+    __m128 d = _mm_sub_ps(x, _mm_cvtepi32_ps(t));
+    t = _mm_sub_epi32(t, _mm_castps_si128(_mm_cmpge_ps(d, half)));
+    t = _mm_add_epi32(t, _mm_castps_si128(_mm_cmple_ps(d, minushalf)));
+    _mm_storeu_ps(samples + i, _mm_cvtepi32_ps(t));
+  }
+  for (; i < count; ++i)
+    samples[i] = quantize_sample(samples[i], scale);
+}
+
+void scan_sse2(const float *samples, unsigned count, SampleScan &scan) {
+  unsigned i = 0;
+  if (count >= 4) {
+    __m128 vmin = _mm_set1_ps(scan.min);
+    __m128 vmax = _mm_set1_ps(scan.max);
+    __m128 integral = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (; i + 4 <= count; i += 4) {
+      __m128 s = _mm_loadu_ps(samples + i);
+      // the second operand if either is NaN, as the comparisons of scan_rest
+      vmin = _mm_min_ps(s, vmin);
+      vmax = _mm_max_ps(s, vmax);
+      __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(s));
+      integral = _mm_and_ps(integral, _mm_cmpeq_ps(s, t));
+    }
+    alignas(16) float lmin[4], lmax[4];
+    _mm_store_ps(lmin, vmin);
+    _mm_store_ps(lmax, vmax);
+    for (unsigned j = 0; j < 4; ++j) {
+      if (lmin[j] < scan.min) scan.min = lmin[j];
+      if (lmax[j] > scan.max) scan.max = lmax[j];
+    }
+    if (_mm_movemask_ps(integral) != 0xf)
+      scan.integral = false;
+  }
+  scan_rest(samples + i, count - i, scan);
+}
+
+}  // namespace
+
+SampleKernels sample_kernels_sse2() {
+  SampleKernels k;
+  k.smooth = &smooth_sse2;
+  k.negate = &negate_sse2;
+  k.multiply = &multiply_sse2;
+  k.mirror = &mirror_sse2;
+  k.interpolate = &interpolate_sse2;
+  k.warp = &warp_sse2;
+  k.normalize = &normalize_sse2;
+  k.quantize = &quantize_sse2;
+  k.scan = &scan_sse2;
+  return k;
+}
@@ -1,10 +1,106 @@
+#define MATH_DSP_KERNELS_IMPL
 #include "math-dsp.h"
+#include "math-dsp-kernels.h"
+#include "math-fft.h"
 #include <speex/speex_resampler.h>
 #include <boost/scope_exit.hpp>
 #include <algorithm>
+#include <list>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <exception>
 #include <stdexcept>
 #include <cmath>
 
+static void smooth_generic(double *data, unsigned size, double s) {
+  if (size < 2)
+    return;
+
+  // each sample reads the next, before the next is written
+  const unsigned count = size - 1;
+  const double t = 1.0 - s;
+  for (unsigned i = 0; i < count; ++i)
+    data[i] = data[i] * s + data[i + 1] * t;
+}
+
+static void negate_generic(double *data, unsigned size) {
+  for (unsigned i = 0; i < size; ++i)
+    data[i] = -data[i];
+}
+
+static void multiply_generic(double *data, const double *factors, unsigned size) {
+  for (unsigned i = 0; i < size; ++i)
+    data[i] *= factors[i];
+}
+
+static void mirror_generic(double *data, unsigned size, bool left_to_right) {
+  const unsigned half = size / 2;
+  // the source half, read forward, and the other, written backward
+  const double *src = left_to_right ? data : data + size - half;
+  double *dst = left_to_right ? data + size - 1 : data + half - 1;
+  for (unsigned i = 0; i < half; ++i)
+    dst[-int(i)] = src[i];
+}
+
+static void interpolate_generic(const float *in, unsigned n, float *out, unsigned m) {
+  interpolate_rest(in, n, out, m, 0);
+}
+
+static void warp_generic(const double *in, const int32_t *index, const int32_t *next,
+                         const double *frac, double *out, unsigned count) {
+  warp_rest(in, index, next, frac, out, count);
+}
+
+static void normalize_generic(float *samples, unsigned count, float divisor) {
+  for (unsigned i = 0; i < count; ++i)
+    samples[i] = normalize_sample(samples[i], divisor);
+}
+
+static void quantize_generic(float *samples, unsigned count, float scale) {
+  for (unsigned i = 0; i < count; ++i)
+    samples[i] = quantize_sample(samples[i], scale);
+}
+
+static void scan_generic(const float *samples, unsigned count, SampleScan &scan) {
+  scan_rest(samples, count, scan);
+}
+
+SampleKernels sample_kernels_generic() {
+  SampleKernels k;
+  k.smooth = &smooth_generic;
+  k.negate = &negate_generic;
+  k.multiply = &multiply_generic;
+  k.mirror = &mirror_generic;
+  k.interpolate = &interpolate_generic;
+  k.warp = &warp_generic;
+  k.normalize = &normalize_generic;
+  k.quantize = &quantize_generic;
+  k.scan = &scan_generic;
+  return k;
+}
+
+SampleKernels sample_kernels_for(CpuPath path) {
+  switch (path) {
+#if defined(DESSINER_X86_SIMD)
+    case CpuAVX2:
+      return sample_kernels_avx2();
+    case CpuSSE2:
+      return sample_kernels_sse2();
+#endif
+    default:
+      return sample_kernels_generic();
+  }
+}
+
+// selected at startup
+static const SampleKernels selected_sample_kernels = sample_kernels_for(cpu_path());
+
+const SampleKernels &sample_kernels() {
+  return selected_sample_kernels;
+}
+
 double tukey_window(double a, double x) {
   if (x < a / 2) {
     return (1.0 + std::cos(M_PI * (2.0 * x / a - 1.0))) / 2.0;
@@ -15,29 +111,182 @@ double tukey_window(double a, double x) {
   }
 }
 
-void resample(const float *in_samples,
-              unsigned in_sample_count,
-              float *out_samples,
-              unsigned out_sample_count) {
-  if (in_sample_count == 0) {
-    std::fill(out_samples, out_samples + out_sample_count, 0.0f);
+TukeyWindow::TukeyWindow(double a, unsigned size)
+  : a_(a), size_(size) {
+  if (size < 2)
     return;
+
+  // the taper at the start, and its mirror at the end, not overlapping
+  for (unsigned i = 0; i < (size + 1) / 2; ++i) {
+    double w = tukey_window(a, double(i) / (size - 1));
+    if (w >= 1.0)
+      break;
+    start_.push_back(w);
   }
+  unsigned end_count = std::min<unsigned>(start_.size(), size / 2);
+  end_.assign(start_.rend() - end_count, start_.rend());
+}
 
-  int err {};
+void TukeyWindow::apply(double *data) const {
+  multiply_samples(data, start_.data(), start_.size());
+  multiply_samples(data + size_ - end_.size(), end_.data(), end_.size());
+}
 
-  SpeexResamplerState *resampler = speex_resampler_init(
-    1, in_sample_count, out_sample_count, SPEEX_RESAMPLER_QUALITY_MAX, &err);
+void smooth_samples(double *data, unsigned size, double s) {
+  sample_kernels().smooth(data, size, s);
+}
+
+void negate_samples(double *data, unsigned size) {
+  sample_kernels().negate(data, size);
+}
+
+void multiply_samples(double *data, const double *factors, unsigned size) {
+  sample_kernels().multiply(data, factors, size);
+}
+
+void mirror_samples(double *data, unsigned size, bool left_to_right) {
+  sample_kernels().mirror(data, size, left_to_right);
+}
+
+void shift_samples(double *data, unsigned size, int offset) {
+  if (size == 0 || offset == 0)
+    return;
+
+  const unsigned distance = std::min<unsigned>(std::abs(offset), size);
+  if (offset > 0) {
+    const double edge = data[0];
+    std::copy_backward(data, data + size - distance, data + size);
+    std::fill(data, data + distance, edge);
+  } else {
+    const double edge = data[size - 1];
+    std::copy(data + distance, data + size, data);
+    std::fill(data + size - distance, data + size, edge);
+  }
+}
 
-  if (!resampler) {
+// resampler states, kept for reuse by their ratio and quality
+//   Initializing a state computes its filter, which costs much more than
+//   resampling a table. A state is taken out for a call, then reset and
+//   given back, so concurrent calls of a same ratio each have their own.
+namespace {
+class ResamplerCache {
+ public:
+  ~ResamplerCache();
+  SpeexResamplerState *take(unsigned in_rate, unsigned out_rate, int quality);
+  void give(SpeexResamplerState *state, unsigned in_rate, unsigned out_rate, int quality);
+
+ private:
+  struct Entry {
+    unsigned in_rate;
+    unsigned out_rate;
+    int quality;
+    SpeexResamplerState *state;
+  };
+
+  // the states not in use, most recently used first
+  static const unsigned capacity = 16;
+  std::mutex mutex_;
+  std::list<Entry> idle_;
+};
+
+ResamplerCache::~ResamplerCache() {
+  for (const Entry &entry : idle_)
+    speex_resampler_destroy(entry.state);
+}
+
+SpeexResamplerState *ResamplerCache::take(unsigned in_rate, unsigned out_rate, int quality) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+      if (it->in_rate == in_rate && it->out_rate == out_rate && it->quality == quality) {
+        SpeexResamplerState *state = it->state;
+        idle_.erase(it);
+        return state;
+      }
+    }
+  }
+
+  int err {};
+  SpeexResamplerState *state = speex_resampler_init(
+    1, in_rate, out_rate, quality, &err);
+
+  if (!state) {
     const char *errmsg = speex_resampler_strerror(err);
     throw std::runtime_error(std::string("speex_resampler_init: ") + errmsg);
   }
 
-  BOOST_SCOPE_EXIT(resampler) {
-    speex_resampler_destroy(resampler);
-  } BOOST_SCOPE_EXIT_END;
+  return state;
+}
+
+void ResamplerCache::give(SpeexResamplerState *state, unsigned in_rate, unsigned out_rate, int quality) {
+  // as if new, for the next use
+  speex_resampler_reset_mem(state);
+
+  SpeexResamplerState *evicted = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_front(Entry{in_rate, out_rate, quality, state});
+    if (idle_.size() > capacity) {
+      evicted = idle_.back().state;
+      idle_.pop_back();
+    }
+  }
+
+  if (evicted)
+    speex_resampler_destroy(evicted);
+}
 
+ResamplerCache resampler_cache;
+}
+
+static int speex_quality(ResampleQuality quality) {
+  switch (quality) {
+    case ResampleSpeexFast:
+      return SPEEX_RESAMPLER_QUALITY_MIN;
+    case ResampleSpeexMedium:
+      return SPEEX_RESAMPLER_QUALITY_DEFAULT;
+    case ResampleSpeexBest:
+      return SPEEX_RESAMPLER_QUALITY_MAX;
+    default:
+      return -1;
+  }
+}
+
+void resample(const float *in_samples,
+              unsigned in_sample_count,
+              float *out_samples,
+              unsigned out_sample_count,
+              ResampleQuality quality) {
+  // the same length is the same signal, at any quality
+  if (in_sample_count == out_sample_count) {
+    std::copy(in_samples, in_samples + in_sample_count, out_samples);
+    return;
+  }
+
+  switch (quality) {
+    case ResampleLinear:
+      resample_linear(in_samples, in_sample_count, out_samples, out_sample_count);
+      break;
+    case ResampleSpeexFast:
+    case ResampleSpeexMedium:
+    case ResampleSpeexBest:
+      resample_speex(in_samples, in_sample_count, out_samples, out_sample_count,
+                     speex_quality(quality));
+      break;
+    case ResamplePeriodic:
+      resample_periodic(in_samples, in_sample_count, out_samples, out_sample_count);
+      break;
+    default:
+      throw std::runtime_error("unsupported resampling quality");
+  }
+}
+
+// one signal through a resampler as new, at the ratio of the counts
+static void speex_process(SpeexResamplerState *resampler,
+                          const float *in_samples,
+                          unsigned in_sample_count,
+                          float *out_samples,
+                          unsigned out_sample_count) {
   speex_resampler_skip_zeros(resampler);
 
   while (out_sample_count > 0) {
@@ -65,3 +314,159 @@ void resample(const float *in_samples,
     out_sample_count -= out_count;
   }
 }
+
+void resample_speex(const float *in_samples,
+                    unsigned in_sample_count,
+                    float *out_samples,
+                    unsigned out_sample_count,
+                    int quality) {
+  if (in_sample_count == 0) {
+    std::fill(out_samples, out_samples + out_sample_count, 0.0f);
+    return;
+  }
+
+  const unsigned in_rate = in_sample_count;
+  const unsigned out_rate = out_sample_count;
+
+  SpeexResamplerState *resampler = resampler_cache.take(in_rate, out_rate, quality);
+
+  BOOST_SCOPE_EXIT(resampler, in_rate, out_rate, quality) {
+    resampler_cache.give(resampler, in_rate, out_rate, quality);
+  } BOOST_SCOPE_EXIT_END;
+
+  speex_process(resampler, in_samples, in_sample_count, out_samples, out_sample_count);
+}
+
+void resample_batch(const float *const *in_tables,
+                    unsigned in_sample_count,
+                    float *const *out_tables,
+                    unsigned out_sample_count,
+                    unsigned table_count,
+                    ResampleQuality quality,
+                    unsigned jobs) {
+  if (jobs == 0)
+    jobs = std::max(1u, std::thread::hardware_concurrency());
+  jobs = std::min(jobs, table_count);
+
+  const int speex = (in_sample_count > 0 && in_sample_count != out_sample_count) ?
+    speex_quality(quality) : -1;
+  const unsigned in_rate = in_sample_count;
+  const unsigned out_rate = out_sample_count;
+
+  // the workers take the next table until there is none left
+  std::atomic<unsigned> next {0};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  auto work = [&]() {
+    try {
+      SpeexResamplerState *resampler = nullptr;
+      if (speex != -1)
+        resampler = resampler_cache.take(in_rate, out_rate, speex);
+
+      BOOST_SCOPE_EXIT(resampler, in_rate, out_rate, speex) {
+        if (resampler)
+          resampler_cache.give(resampler, in_rate, out_rate, speex);
+      } BOOST_SCOPE_EXIT_END;
+
+      for (unsigned i = next++; i < table_count; i = next++) {
+        if (resampler) {
+          speex_process(resampler, in_tables[i], in_sample_count,
+                        out_tables[i], out_sample_count);
+          speex_resampler_reset_mem(resampler);
+        } else {
+          resample(in_tables[i], in_sample_count,
+                   out_tables[i], out_sample_count, quality);
+        }
+      }
+    } catch (...) {
+      // the first error is thrown again, the other workers stop
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+      next = table_count;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned j = 1; j < jobs; ++j)
+    workers.emplace_back(work);
+  work();
+  for (std::thread &worker : workers)
+    worker.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+void resample_periodic(const float *in_samples,
+                       unsigned in_sample_count,
+                       float *out_samples,
+                       unsigned out_sample_count) {
+  if (in_sample_count == 0) {
+    std::fill(out_samples, out_samples + out_sample_count, 0.0f);
+    return;
+  }
+  if (in_sample_count == out_sample_count) {
+    std::copy(in_samples, in_samples + in_sample_count, out_samples);
+    return;
+  }
+  if (out_sample_count == 0)
+    return;
+
+  typedef std::complex<double> cpx;
+  const unsigned n = in_sample_count;
+  const unsigned m = out_sample_count;
+
+  std::vector<cpx> in_spectrum(n / 2 + 1);
+  real_fft(in_samples, n, in_spectrum.data());
+
+  // the bins both sizes have, apart from Nyquist bins of even sizes
+  std::vector<cpx> out_spectrum(m / 2 + 1);
+  const double scale = double(m) / n;
+  const unsigned common = std::min((n - 1) / 2, (m - 1) / 2);
+  for (unsigned k = 0; k <= common; ++k)
+    out_spectrum[k] = scale * in_spectrum[k];
+
+  if (n % 2 == 0 && n / 2 < m / 2 + (m % 2)) {
+    // the input Nyquist cosine, shared between a pair of bins
+    out_spectrum[n / 2] = 0.5 * scale * in_spectrum[n / 2].real();
+  } else if (m % 2 == 0 && m / 2 <= n / 2) {
+    // the output Nyquist, the sum of a bin with its mirror
+    out_spectrum[m / 2] = 2 * scale * in_spectrum[m / 2].real();
+  }
+
+  real_ifft(out_spectrum.data(), m, out_samples);
+}
+
+void resample_linear(const float *in_samples,
+                     unsigned in_sample_count,
+                     float *out_samples,
+                     unsigned out_sample_count) {
+  if (in_sample_count == 0) {
+    std::fill(out_samples, out_samples + out_sample_count, 0.0f);
+    return;
+  }
+
+  sample_kernels().interpolate(in_samples, in_sample_count, out_samples, out_sample_count);
+}
+
+void normalize_samples(float *samples, unsigned count, float divisor) {
+  sample_kernels().normalize(samples, count, divisor);
+}
+
+void quantize_samples(float *samples, unsigned count, float scale) {
+  sample_kernels().quantize(samples, count, scale);
+}
+
+void scan_samples(const float *samples, unsigned count,
+                  float &min, float &max, bool &integral) {
+  SampleScan scan {0.0f, 0.0f, true};
+  if (count > 0) {
+    scan.min = scan.max = samples[0];
+    sample_kernels().scan(samples, count, scan);
+  }
+  min = scan.min;
+  max = scan.max;
+  integral = scan.integral;
+}
@@ -1,10 +1,98 @@
 #pragma once
+#include <vector>
 
 // window function, x in [0,1]
 double tukey_window(double a, double x);
 
-// resampling a full signal
+// a Tukey window over a number of samples, computed once
+//   Only the tapers are stored, the middle of the window being 1.
+class TukeyWindow {
+ public:
+  TukeyWindow(double a, unsigned size);
+
+  double a() const { return a_; }
+  unsigned size() const { return size_; }
+
+  // multiplies `size` samples by the window
+  void apply(double *data) const;
+
+ private:
+  double a_ {};
+  unsigned size_ {};
+  std::vector<double> start_;
+  std::vector<double> end_;
+};
+
+// operations on tables, in place and without allocation
+//   smoothing blends each sample with the next, by `s` and 1 - `s`
+void smooth_samples(double *data, unsigned size, double s);
+void negate_samples(double *data, unsigned size);
+void multiply_samples(double *data, const double *factors, unsigned size);
+// copies the first half, reversed, over the second, or the reverse
+void mirror_samples(double *data, unsigned size, bool left_to_right);
+// moves the samples right by `offset`, repeating the edge samples
+void shift_samples(double *data, unsigned size, int offset);
+
+// conversions of samples, in place
+//   dividing, then clamping to [-1, 1], with non-finite values as 0
+void normalize_samples(float *samples, unsigned count, float divisor);
+//   multiplying, then rounding half away from zero within [-scale - 1, scale],
+//   with NaN as 0
+void quantize_samples(float *samples, unsigned count, float scale);
+//   the range of values, and whether all are integers within the range of int
+void scan_samples(const float *samples, unsigned count,
+                  float &min, float &max, bool &integral);
+
+// algorithms of resampling, from the fastest to the most exact
+enum ResampleQuality {
+  // periodic linear interpolation, for previews
+  ResampleLinear,
+  // Speex at qualities 0, 4 and 10, treating the table as finite
+  ResampleSpeexFast,
+  ResampleSpeexMedium,
+  ResampleSpeexBest,
+  // by the spectrum, see resample_periodic
+  ResamplePeriodic,
+};
+
+#define RESAMPLE_QUALITY_NAMES                  \
+  {"Linear", "Speex fast", "Speex medium",      \
+   "Speex best", "Periodic"}
+
+// resampling a full signal, copied through at the same length
 void resample(const float *in_samples,
               unsigned in_sample_count,
               float *out_samples,
-              unsigned out_sample_count);
+              unsigned out_sample_count,
+              ResampleQuality quality);
+
+// resampling many tables of one size to another, spread over `jobs`
+// threads, 0 for one per processor; each thread keeps one resampler
+// for all the tables it takes
+void resample_batch(const float *const *in_tables,
+                    unsigned in_sample_count,
+                    float *const *out_tables,
+                    unsigned out_sample_count,
+                    unsigned table_count,
+                    ResampleQuality quality,
+                    unsigned jobs = 0);
+
+// resampling with Speex at a quality from 0 to 10
+void resample_speex(const float *in_samples,
+                    unsigned in_sample_count,
+                    float *out_samples,
+                    unsigned out_sample_count,
+                    int quality);
+
+// resampling one period by linear interpolation, wrapping at the end
+void resample_linear(const float *in_samples,
+                     unsigned in_sample_count,
+                     float *out_samples,
+                     unsigned out_sample_count);
+
+// resampling one period of a periodic signal, by zero-padding or truncating
+// its spectrum; exact for a band-limited signal, and continuous at the wrap
+void resample_periodic(const float *in_samples,
+                       unsigned in_sample_count,
+                       float *out_samples,
+                       unsigned out_sample_count);
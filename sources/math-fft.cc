@@ -0,0 +1,236 @@
+#include "math-fft.h"
+#include <map>
+#include <mutex>
+#include <cmath>
+
+typedef std::complex<double> cpx;
+
+// product without the checks of infinities of std::complex, much faster
+static inline cpx mul(cpx a, cpx b) {
+  return cpx(a.real() * b.real() - a.imag() * b.imag(),
+             a.real() * b.imag() + a.imag() * b.real());
+}
+
+static bool is_power_of_2(unsigned n) {
+  return n > 0 && (n & (n - 1)) == 0;
+}
+
+FFTPlan::FFTPlan(unsigned size)
+  : size_(size) {
+  if (size < 2)
+    return;
+
+  if (size % 2 == 0) {
+    packing_.resize(size / 2);
+    for (unsigned i = 0; i < size / 2; ++i)
+      packing_[i] = std::polar(1.0, -2.0 * M_PI * i / size);
+  }
+
+  if (is_power_of_2(size)) {
+    unsigned bits = 0;
+    while ((1u << bits) < size)
+      ++bits;
+
+    bitrev_.resize(size);
+    for (unsigned i = 0; i < size; ++i) {
+      unsigned r = 0;
+      for (unsigned b = 0; b < bits; ++b)
+        r |= ((i >> b) & 1) << (bits - 1 - b);
+      bitrev_[i] = r;
+    }
+
+    twiddles_.resize(size / 2);
+    for (unsigned i = 0; i < size / 2; ++i)
+      twiddles_[i] = std::polar(1.0, -2.0 * M_PI * i / size);
+  } else {
+    unsigned m = 1;
+    while (m < 2 * size - 1)
+      m <<= 1;
+    sub_.reset(new FFTPlan(m));
+
+    chirp_.resize(size);
+    for (unsigned i = 0; i < size; ++i) {
+      // reduce i^2 modulo 2*size to keep the angle precise
+      unsigned long long k = (unsigned long long)i * i % (2ull * size);
+      chirp_[i] = std::polar(1.0, -M_PI * k / size);
+    }
+
+    chirpSpectrum_.assign(m, cpx());
+    chirpSpectrum_[0] = std::conj(chirp_[0]);
+    for (unsigned i = 1; i < size; ++i)
+      chirpSpectrum_[i] = chirpSpectrum_[m - i] = std::conj(chirp_[i]);
+    sub_->forward(chirpSpectrum_.data());
+  }
+}
+
+FFTPlan::~FFTPlan() {
+}
+
+void FFTPlan::forward(cpx *data) const {
+  transform(data, false);
+}
+
+void FFTPlan::inverse(cpx *data) const {
+  transform(data, true);
+  double scale = 1.0 / size_;
+  for (unsigned i = 0; i < size_; ++i)
+    data[i] *= scale;
+}
+
+void FFTPlan::transform(cpx *data, bool inverse) const {
+  if (size_ < 2)
+    return;
+  if (sub_)
+    bluestein(data, inverse);
+  else
+    radix2(data, inverse);
+}
+
+void FFTPlan::radix2(cpx *data, bool inverse) const {
+  const unsigned n = size_;
+
+  for (unsigned i = 0; i < n; ++i) {
+    unsigned r = bitrev_[i];
+    if (i < r)
+      std::swap(data[i], data[r]);
+  }
+
+  for (unsigned len = 2; len <= n; len <<= 1) {
+    unsigned half = len / 2;
+    unsigned step = n / len;
+    for (unsigned i = 0; i < n; i += len) {
+      for (unsigned j = 0; j < half; ++j) {
+        cpx w = twiddles_[j * step];
+        if (inverse)
+          w = std::conj(w);
+        cpx a = data[i + j];
+        cpx b = mul(data[i + j + half], w);
+        data[i + j] = a + b;
+        data[i + j + half] = a - b;
+      }
+    }
+  }
+}
+
+void FFTPlan::bluestein(cpx *data, bool inverse) const {
+  const unsigned n = size_;
+  const unsigned m = sub_->size();
+
+  // the inverse is the forward transform of the conjugate, conjugated
+  std::vector<cpx> work(m);
+  for (unsigned i = 0; i < n; ++i) {
+    cpx x = inverse ? std::conj(data[i]) : data[i];
+    work[i] = mul(x, chirp_[i]);
+  }
+
+  sub_->forward(work.data());
+  for (unsigned i = 0; i < m; ++i)
+    work[i] = mul(work[i], chirpSpectrum_[i]);
+  sub_->inverse(work.data());
+
+  for (unsigned i = 0; i < n; ++i) {
+    cpx y = mul(work[i], chirp_[i]);
+    data[i] = inverse ? std::conj(y) : y;
+  }
+}
+
+const FFTPlan &fft_plan(unsigned size) {
+  static std::mutex mutex;
+  static std::map<unsigned, std::unique_ptr<FFTPlan>> plans;
+
+  // plans live to the end, so each thread remembers those it used,
+  // and threads transforming together do not wait on the lock
+  thread_local std::map<unsigned, const FFTPlan *> known;
+  const FFTPlan *&found = known[size];
+  if (found)
+    return *found;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<FFTPlan> &plan = plans[size];
+  if (!plan)
+    plan.reset(new FFTPlan(size));
+  found = plan.get();
+  return *plan;
+}
+
+template <class T>
+static void real_fft_impl(const T *in, unsigned size, cpx *spectrum) {
+  if (size % 2 != 0) {
+    std::vector<cpx> work(in, in + size);
+    fft_plan(size).forward(work.data());
+    std::copy(work.begin(), work.begin() + size / 2 + 1, spectrum);
+    return;
+  }
+
+  // even samples as real parts and odd ones as imaginary parts
+  const unsigned half = size / 2;
+  std::vector<cpx> work(half);
+  for (unsigned i = 0; i < half; ++i)
+    work[i] = cpx(in[2 * i], in[2 * i + 1]);
+  fft_plan(half).forward(work.data());
+
+  // separate the spectra of the halves, and join them
+  const cpx *w = fft_plan(size).packing().data();
+  for (unsigned k = 0; k < half; ++k) {
+    cpx z = work[k];
+    cpx zc = std::conj(work[k ? half - k : 0]);
+    cpx even = 0.5 * (z + zc);
+    cpx odd = cpx(0.0, -0.5) * (z - zc);
+    spectrum[k] = even + mul(w[k], odd);
+    if (k == 0)
+      spectrum[half] = even - odd;
+  }
+}
+
+template <class T>
+static void real_ifft_impl(const cpx *spectrum, unsigned size, T *out) {
+  if (size == 0)
+    return;
+
+  if (size % 2 != 0) {
+    std::vector<cpx> work(size);
+    work[0] = spectrum[0];
+    for (unsigned i = 1; i <= size / 2; ++i) {
+      work[i] = spectrum[i];
+      work[size - i] = std::conj(spectrum[i]);
+    }
+    fft_plan(size).inverse(work.data());
+    for (unsigned i = 0; i < size; ++i)
+      out[i] = work[i].real();
+    return;
+  }
+
+  // the spectra of the even and odd samples, as one of half the size
+  const unsigned half = size / 2;
+  const cpx *w = fft_plan(size).packing().data();
+  std::vector<cpx> work(half);
+  for (unsigned k = 0; k < half; ++k) {
+    // the offset and the Nyquist bin of a real signal are real
+    cpx x = k ? spectrum[k] : cpx(spectrum[0].real());
+    cpx xc = k ? std::conj(spectrum[half - k]) : cpx(spectrum[half].real());
+    cpx even = 0.5 * (x + xc);
+    cpx odd = mul(0.5 * (x - xc), std::conj(w[k]));
+    work[k] = even + cpx(-odd.imag(), odd.real());
+  }
+  fft_plan(half).inverse(work.data());
+  for (unsigned i = 0; i < half; ++i) {
+    out[2 * i] = work[i].real();
+    out[2 * i + 1] = work[i].imag();
+  }
+}
+
+void real_fft(const double *in, unsigned size, cpx *spectrum) {
+  real_fft_impl(in, size, spectrum);
+}
+
+void real_fft(const float *in, unsigned size, cpx *spectrum) {
+  real_fft_impl(in, size, spectrum);
+}
+
+void real_ifft(const cpx *spectrum, unsigned size, double *out) {
+  real_ifft_impl(spectrum, size, out);
+}
+
+void real_ifft(const cpx *spectrum, unsigned size, float *out) {
+  real_ifft_impl(spectrum, size, out);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <complex>
+#include <vector>
+#include <memory>
+
+// complex discrete Fourier transform of any size
+class FFTPlan {
+ public:
+  explicit FFTPlan(unsigned size);
+  ~FFTPlan();
+
+  unsigned size() const { return size_; }
+
+  // e^(-2 pi i k / size) for k in [0, size/2), for even sizes, which
+  // join the halves of a real transform done at half the size
+  const std::vector<std::complex<double>> &packing() const { return packing_; }
+
+  // in-place transforms, the inverse is scaled by 1/size
+  void forward(std::complex<double> *data) const;
+  void inverse(std::complex<double> *data) const;
+
+ private:
+  void transform(std::complex<double> *data, bool inverse) const;
+  void radix2(std::complex<double> *data, bool inverse) const;
+  void bluestein(std::complex<double> *data, bool inverse) const;
+
+  unsigned size_ {};
+  // radix-2
+  std::vector<std::complex<double>> twiddles_;
+  std::vector<unsigned> bitrev_;
+  // Bluestein, for sizes which are not powers of 2
+  std::unique_ptr<FFTPlan> sub_;
+  std::vector<std::complex<double>> chirp_;
+  std::vector<std::complex<double>> chirpSpectrum_;
+  std::vector<std::complex<double>> packing_;
+};
+
+// a shared plan for the given size, created on first use
+const FFTPlan &fft_plan(unsigned size);
+
+// spectrum of a real periodic signal, bins 0 to size/2 inclusive
+//   Even sizes are transformed as a complex signal of half the size.
+void real_fft(const double *in, unsigned size, std::complex<double> *spectrum);
+void real_fft(const float *in, unsigned size, std::complex<double> *spectrum);
+
+// real periodic signal from bins 0 to size/2 inclusive
+void real_ifft(const std::complex<double> *spectrum, unsigned size, double *out);
+void real_ifft(const std::complex<double> *spectrum, unsigned size, float *out);
@@ -0,0 +1,120 @@
+#include "math-filter.h"
+#include "math-fft.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <cstddef>
+#include <cmath>
+
+typedef std::complex<double> cpx;
+
+// the one-pole in a direction, starting from the state it has after
+// filtering the period forever, which is a geometric sum over the period
+static void one_pole_periodic(double *data, unsigned size, ptrdiff_t stride, double s) {
+  double acc = 0;
+  for (unsigned i = 0; i < size; ++i)
+    acc = acc * s + data[ptrdiff_t(i) * stride];
+
+  double y = (1.0 - s) * acc / (1.0 - std::pow(s, size));
+  for (unsigned i = 0; i < size; ++i) {
+    y = (1.0 - s) * data[ptrdiff_t(i) * stride] + s * y;
+    data[ptrdiff_t(i) * stride] = y;
+  }
+}
+
+static void filter_one_pole(double *data, unsigned size, double cutoff) {
+  double s = std::exp(-2.0 * M_PI * cutoff / size);
+  if (s <= 0.0)
+    return;
+  one_pole_periodic(data, size, 1, s);
+  one_pole_periodic(data + size - 1, size, -1, s);
+}
+
+static void filter_harmonic(double *data, unsigned size, double cutoff) {
+  std::vector<cpx> spectrum(size / 2 + 1);
+  real_fft(data, size, spectrum.data());
+
+  for (unsigned k = 1; k < spectrum.size(); ++k) {
+    if (k > cutoff)
+      spectrum[k] = 0;
+    else {
+      // sigma factors, against the ringing of a truncated series
+      double x = M_PI * k / (std::floor(cutoff) + 1);
+      spectrum[k] *= std::sin(x) / x;
+    }
+  }
+
+  real_ifft(spectrum.data(), size, data);
+}
+
+static void filter_savitzky_golay(double *data, unsigned size, double cutoff) {
+  // the window of the -3 dB cutoff, after Schafer, "What is a
+  // Savitzky-Golay filter?", for a quadratic: f = 3 / (3.2 M - 4.6)
+  double f = cutoff / size;
+  unsigned window = unsigned(std::lround((3.0 / f + 4.6) / 3.2));
+  unsigned half = std::min(window / 2, (size - 1) / 2);
+  if (half < 2)
+    return;
+
+  // the least-squares quadratic, evaluated at the center
+  std::vector<double> kernel(half + 1);
+  double m = half;
+  double norm = (2 * m + 1) * (4 * m * m + 4 * m - 3);
+  for (unsigned j = 0; j <= half; ++j)
+    kernel[j] = 3.0 * (3 * m * m + 3 * m - 1 - 5.0 * j * j) / norm;
+
+  std::vector<double> in(data, data + size);
+  circular_convolve(in.data(), data, size, kernel.data(), half);
+}
+
+void filter_table(double *data, unsigned size, TableFilter filter, double cutoff) {
+  if (size < 2 || cutoff <= 0)
+    return;
+
+  switch (filter) {
+    case FilterOnePole:
+      filter_one_pole(data, size, cutoff);
+      break;
+    case FilterHarmonic:
+      filter_harmonic(data, size, cutoff);
+      break;
+    case FilterSavitzkyGolay:
+      filter_savitzky_golay(data, size, cutoff);
+      break;
+    default:
+      throw std::runtime_error("unsupported table filter");
+  }
+}
+
+void circular_convolve(const double *in, double *out, unsigned size,
+                       const double *kernel, unsigned half) {
+  // directly for short kernels, by the spectrum otherwise
+  if (half < 32) {
+    for (unsigned i = 0; i < size; ++i) {
+      double acc = kernel[0] * in[i];
+      for (unsigned j = 1; j <= half; ++j) {
+        unsigned back = (i + size - j % size) % size;
+        unsigned ahead = (i + j) % size;
+        acc += kernel[j] * (in[back] + in[ahead]);
+      }
+      out[i] = acc;
+    }
+    return;
+  }
+
+  // the kernel wrapped around the period, real and even
+  std::vector<double> wrapped(size);
+  wrapped[0] += kernel[0];
+  for (unsigned j = 1; j <= half; ++j) {
+    wrapped[j % size] += kernel[j];
+    wrapped[(size - j % size) % size] += kernel[j];
+  }
+
+  std::vector<cpx> response(size / 2 + 1);
+  std::vector<cpx> spectrum(size / 2 + 1);
+  real_fft(wrapped.data(), size, response.data());
+  real_fft(in, size, spectrum.data());
+  for (unsigned k = 0; k < spectrum.size(); ++k)
+    spectrum[k] *= response[k].real();
+  real_ifft(spectrum.data(), size, out);
+}
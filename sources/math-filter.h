@@ -0,0 +1,22 @@
+#pragma once
+
+// zero-phase filters of one period, wrapping around its ends
+enum TableFilter {
+  // one-pole low-pass run forward then backward, from its periodic state
+  FilterOnePole,
+  // harmonics above the cutoff removed, the others tapered by Lanczos sigma
+  FilterHarmonic,
+  // quadratic Savitzky-Golay, by circular convolution
+  FilterSavitzkyGolay,
+};
+
+#define TABLE_FILTER_NAMES                      \
+  {"One-pole", "Harmonic", "Savitzky-Golay"}
+
+// filters `size` samples in place, the cutoff counted in harmonics
+void filter_table(double *data, unsigned size, TableFilter filter, double cutoff);
+
+// out[i] = sum of in[i + j] * kernel[j], j from -half to half, wrapping
+//   The kernel is symmetric, given from its center: half + 1 values.
+void circular_convolve(const double *in, double *out, unsigned size,
+                       const double *kernel, unsigned half);
@@ -1,5 +1,6 @@
 #include "new-wave-editor.h"
 #include "ui_new-wave-editor.h"
+#include "phase-warp.h"
 #include <QAbstractButton>
 #include <QAction>
 #include <QMenu>
@@ -87,8 +88,11 @@ bool NewWaveEditor::computeWave(double *out, unsigned length, const QString &wav
         return false;
     }
 
+    if(!m_phaseWarp || m_phaseWarp->amount() != phaseDistort || m_phaseWarp->size() != length)
+        m_phaseWarp.reset(new PhaseWarp(phaseDistort, length));
+
     ///
-    for(unsigned i = 0; i < 1024; ++i)
+    for(unsigned i = 0; i < length; ++i)
     {
         int gen = lua_getglobal(L.get(), "wave");
         if (gen == 0) {
@@ -97,8 +101,7 @@ bool NewWaveEditor::computeWave(double *out, unsigned length, const QString &wav
             return false;
         }
 
-        double phase = (double)i / 1024;
-        phase = distortPhase(phase, phaseDistort);
+        double phase = m_phaseWarp->phase(i);
 
         lua_pushnumber(L.get(), phase);
 
@@ -124,35 +127,6 @@ bool NewWaveEditor::computeWave(double *out, unsigned length, const QString &wav
     return true;
 }
 
-double NewWaveEditor::distortPhase(double phase, double amt)
-{
-    phase = phase * 2 - 1;
-
-    if(amt > 0) // positive distortion
-    {
-        double amin = 0.5;
-        double amax = 5;
-        double a = amin + amt * (amax - amin);
-        double p = tanh(phase * a);
-        phase = p / fabs(tanh(-a));
-    }
-    else if(amt < 0) // negative distortion
-    {
-        amt = -16 * amt;
-
-        auto g = [](double x, double a) -> double
-                     { return pow(2, -a * (1 - x)); };
-        double g0 = g(0, amt);
-        double g1 = g(1, amt);
-        double p = (g(fabs(phase), amt) - g0) / (g1 - g0);
-        phase = (phase < 0) ? -p : +p;
-    }
-
-    phase = (phase + 1) * 0.5;
-
-    return phase;
-}
-
 void NewWaveEditor::updateWaveDisplay()
 {
     m_ui->waveCurrent->setData(m_waveCurrent, 1024);
@@ -4,6 +4,7 @@
 
 namespace Ui { class NewWaveEditor; }
 class QAbstractButton;
+class PhaseWarp;
 
 class NewWaveEditor : public QDialog
 {
@@ -29,7 +30,6 @@ private slots:
 private:
     void updateWaveDisplay();
     bool computeWave(double *out, unsigned length, const QString &waveCode, double phaseDistort);
-    static double distortPhase(double phase, double amt);
 
     void initGenerators();
     void initWaveCode();
@@ -37,6 +37,8 @@ private:
     void showError(const QString &error);
 
     std::unique_ptr<Ui::NewWaveEditor> m_ui;
+    // the distorted phases, kept while the amount is the same
+    std::unique_ptr<PhaseWarp> m_phaseWarp;
 
     struct WaveOptions
     {
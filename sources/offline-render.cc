@@ -0,0 +1,38 @@
+#include "offline-render.h"
+#include "wave-table.h"
+#include <algorithm>
+#include <cmath>
+
+std::vector<float> render_offline(const MipmapWavetable &table,
+                                  const OfflineRender &settings) {
+  const double rate = settings.sampleRate;
+  const size_t frame_count = std::max(0.0, std::round(settings.duration * rate));
+  std::vector<float> out(frame_count);
+
+  if (table.levelCount() == 0 || rate <= 0)
+    return out;
+
+  const double f1 = settings.startFreq;
+  const double f2 = settings.endFreq;
+  const bool exponential = settings.exponential && f1 > 0 && f2 > 0;
+
+  // the frequency is held for a block, evaluated at its middle
+  const unsigned block_size = 64;
+  uint32_t phase = 0;
+
+  for (size_t i = 0; i < frame_count; i += block_size) {
+    unsigned count = std::min<size_t>(block_size, frame_count - i);
+    double x = (frame_count > 1) ? (i + 0.5 * count) / frame_count : 0.0;
+    double freq = exponential ?
+      f1 * std::pow(f2 / f1, x) : f1 + x * (f2 - f1);
+
+    MipmapWavetable::Selection sel = table.select(freq, rate);
+    unsigned nextlevel = sel.level + ((sel.mix > 0) ? 1 : 0);
+    phase = render_wavetable(
+      table.level(sel.level), table.level(nextlevel), sel.mix,
+      table.log2Size(), phase, phase_increment(freq, rate),
+      &out[i], count, settings.quality);
+  }
+
+  return out;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "wave-render.h"
+#include <vector>
+
+class MipmapWavetable;
+
+struct OfflineRender {
+  double sampleRate = 48000;
+  double duration = 5;  // seconds
+  // a sweep if the frequencies differ
+  double startFreq = 220;
+  double endFreq = 220;
+  bool exponential = true;
+  InterpolationQuality quality = InterpHermite;
+};
+
+// renders the tone of a table, as fast as possible, apart from the device
+std::vector<float> render_offline(const MipmapWavetable &table,
+                                  const OfflineRender &settings);
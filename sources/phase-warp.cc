@@ -0,0 +1,45 @@
+#include "phase-warp.h"
+#include "math-dsp-kernels.h"
+#include <cmath>
+
+double warp_phase(double phase, double amount) {
+  phase = phase * 2 - 1;
+
+  if (amount > 0) {
+    double amin = 0.5;
+    double amax = 5;
+    double a = amin + amount * (amax - amin);
+    double p = std::tanh(phase * a);
+    phase = p / std::fabs(std::tanh(-a));
+  } else if (amount < 0) {
+    double a = -16 * amount;
+    auto g = [a](double x) -> double { return std::exp2(-a * (1 - x)); };
+    double g0 = g(0);
+    double g1 = g(1);
+    double p = (g(std::fabs(phase)) - g0) / (g1 - g0);
+    phase = (phase < 0) ? -p : +p;
+  }
+
+  return (phase + 1) * 0.5;
+}
+
+PhaseWarp::PhaseWarp(double amount, unsigned size)
+  : amount_(amount), size_(size),
+    index_(size), next_(size), frac_(size) {
+  for (unsigned i = 0; i < size; ++i) {
+    double position = warp_phase(double(i) / size, amount) * size;
+    unsigned index = unsigned(position);
+    double frac = position - index;
+    if (index >= size) {
+      index = 0;
+      frac = 0;
+    }
+    index_[i] = index;
+    next_[i] = (index + 1 < size) ? index + 1 : 0;
+    frac_[i] = frac;
+  }
+}
+
+void PhaseWarp::apply(const double *in, double *out) const {
+  sample_kernels().warp(in, index_.data(), next_.data(), frac_.data(), out, size_);
+}
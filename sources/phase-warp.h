@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// phase distortion of one period, the phase in [0, 1] mapped onto itself
+//   Positive amounts, to 1, hold the phase near the ends of the period by
+//   tanh; negative ones, to -1, near the middle by an exponential.
+double warp_phase(double phase, double amount);
+
+// phase distortion applied to a table, computed once per amount
+//   The table is read at the distorted phases of its samples, by linear
+//   interpolation, from positions kept as index and fraction.
+class PhaseWarp {
+ public:
+  PhaseWarp(double amount, unsigned size);
+
+  double amount() const { return amount_; }
+  unsigned size() const { return size_; }
+
+  // the distorted phase of sample `i`, in [0, 1]
+  double phase(unsigned i) const { return (index_[i] + frac_[i]) / size_; }
+
+  // `size` samples read from `in` into `out`, which are distinct
+  void apply(const double *in, double *out) const;
+
+ private:
+  double amount_ {};
+  unsigned size_ {};
+  std::vector<int32_t> index_;
+  // the sample after the index, wrapping at the end
+  std::vector<int32_t> next_;
+  std::vector<double> frac_;
+};
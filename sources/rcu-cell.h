@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+// publishes immutable objects from a writer thread to a reader thread
+//   The reader pins the current object with a hazard pointer, never
+//   blocking, allocating or freeing. The writer retires replaced objects
+//   and deletes them once the reader is known not to hold them.
+template <class T>
+class RcuCell {
+ public:
+  RcuCell() {}
+  ~RcuCell();
+
+  RcuCell(const RcuCell &) = delete;
+  RcuCell &operator=(const RcuCell &) = delete;
+
+  // writer side
+  void publish(std::unique_ptr<const T> object);
+  void collect();
+  const T *published() const { return current_.load(std::memory_order_relaxed); }
+
+  // reader side, one pinned object at a time
+  const T *acquire();
+  void release();
+
+ private:
+  std::atomic<const T *> current_ {nullptr};
+  std::atomic<const T *> hazard_ {nullptr};
+  std::vector<std::unique_ptr<const T>> retired_;
+};
+
+template <class T>
+RcuCell<T>::~RcuCell() {
+  delete current_.load();
+}
+
+template <class T>
+void RcuCell<T>::publish(std::unique_ptr<const T> object) {
+  const T *old = current_.exchange(object.release());
+  if (old)
+    retired_.emplace_back(old);
+  collect();
+}
+
+template <class T>
+void RcuCell<T>::collect() {
+  const T *pinned = hazard_.load();
+  retired_.erase(
+    std::remove_if(retired_.begin(), retired_.end(),
+                   [pinned](const std::unique_ptr<const T> &p) { return p.get() != pinned; }),
+    retired_.end());
+}
+
+template <class T>
+const T *RcuCell<T>::acquire() {
+  // confirm that the pin was made before the object could be retired
+  const T *p = current_.load();
+  for (;;) {
+    hazard_.store(p);
+    const T *q = current_.load();
+    if (q == p)
+      return p;
+    p = q;
+  }
+}
+
+template <class T>
+void RcuCell<T>::release() {
+  hazard_.store(nullptr, std::memory_order_release);
+}
@@ -0,0 +1,144 @@
+#include "render-dialog.h"
+#include "offline-render.h"
+#include "riff-wave.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <algorithm>
+#include <cmath>
+
+static const QStringList sampleformatnames = RIFF_SAMPLE_FORMAT_NAMES;
+static const QStringList qualitynames = INTERPOLATION_QUALITY_NAMES;
+///
+
+struct RenderDialog::Impl {
+  QLineEdit *valFilename {};
+  QSpinBox *valSampleRate {};
+  QDoubleSpinBox *valDuration {};
+  QDoubleSpinBox *valStartFreq {};
+  QDoubleSpinBox *valEndFreq {};
+  QCheckBox *chkExponential {};
+  QComboBox *selQuality {};
+  QComboBox *selSampleFormat {};
+};
+
+RenderDialog::RenderDialog(QWidget *parent)
+  : QDialog(parent), P(new Impl) {
+  this->setWindowTitle("Render to WAV");
+
+  QVBoxLayout *layout = new QVBoxLayout;
+  this->setLayout(layout);
+
+  QFormLayout *form = new QFormLayout;
+  layout->addLayout(form);
+
+  QHBoxLayout *layoutFileSelect = new QHBoxLayout;
+  P->valFilename = new QLineEdit;
+  layoutFileSelect->addWidget(P->valFilename);
+  QPushButton *btnFileSelect = new QPushButton("Choose...");
+  layoutFileSelect->addWidget(btnFileSelect);
+  form->addRow("File name", layoutFileSelect);
+
+  P->valSampleRate = new QSpinBox;
+  P->valSampleRate->setRange(8000, 384000);
+  P->valSampleRate->setValue(48000);
+  form->addRow("Sample rate", P->valSampleRate);
+
+  P->valDuration = new QDoubleSpinBox;
+  P->valDuration->setRange(0.01, 3600.0);
+  P->valDuration->setValue(5.0);
+  form->addRow("Duration (s)", P->valDuration);
+
+  P->valStartFreq = new QDoubleSpinBox;
+  P->valStartFreq->setRange(1.0, 20000.0);
+  P->valStartFreq->setValue(220.0);
+  form->addRow("Start frequency", P->valStartFreq);
+
+  P->valEndFreq = new QDoubleSpinBox;
+  P->valEndFreq->setRange(1.0, 20000.0);
+  P->valEndFreq->setValue(220.0);
+  form->addRow("End frequency", P->valEndFreq);
+
+  P->chkExponential = new QCheckBox;
+  P->chkExponential->setChecked(true);
+  form->addRow("Exponential sweep", P->chkExponential);
+
+  P->selQuality = new QComboBox;
+  P->selQuality->addItems(qualitynames);
+  P->selQuality->setCurrentIndex(InterpSinc);
+  form->addRow("Interpolation", P->selQuality);
+
+  P->selSampleFormat = new QComboBox;
+  P->selSampleFormat->addItems(sampleformatnames);
+  form->addRow("Sample format", P->selSampleFormat);
+
+  QDialogButtonBox *buttonbox = new QDialogButtonBox(
+    QDialogButtonBox::Save|QDialogButtonBox::Cancel);
+  layout->addWidget(buttonbox);
+
+  QObject::connect(btnFileSelect, &QPushButton::clicked,
+                   this, &RenderDialog::chooseFile);
+
+  QObject::connect(buttonbox, &QDialogButtonBox::accepted,
+                   this, &RenderDialog::accept);
+  QObject::connect(buttonbox, &QDialogButtonBox::rejected,
+                   this, &RenderDialog::reject);
+}
+
+RenderDialog::~RenderDialog() {
+}
+
+OfflineRender RenderDialog::renderSettings() const {
+  OfflineRender settings;
+  settings.sampleRate = P->valSampleRate->value();
+  settings.duration = P->valDuration->value();
+  settings.startFreq = P->valStartFreq->value();
+  settings.endFreq = P->valEndFreq->value();
+  settings.exponential = P->chkExponential->isChecked();
+  settings.quality = InterpolationQuality(P->selQuality->currentIndex());
+  return settings;
+}
+
+int RenderDialog::renderSampleFormat() const {
+  return RiffSampleFormat(P->selSampleFormat->currentIndex());
+}
+
+QString RenderDialog::waveFilename() const {
+  return P->valFilename->text();
+}
+
+void RenderDialog::accept() {
+  // refused before rendering, rather than after
+  OfflineRender settings = renderSettings();
+  const size_t frame_count = std::max(
+    0.0, std::round(settings.duration * settings.sampleRate));
+  if (!riff_wave_fits(frame_count, 1, RiffSampleFormat(renderSampleFormat()))) {
+    QMessageBox::warning(
+      this, "Render to WAV",
+      "The file would exceed the 4 GiB of a WAV file. "
+      "Shorten the duration, or lower the sample rate.");
+    return;
+  }
+  QDialog::accept();
+}
+
+void RenderDialog::chooseFile() {
+  QFileDialog *filedialog = new QFileDialog(this, "Save file");
+  filedialog->setAcceptMode(QFileDialog::AcceptSave);
+  filedialog->setNameFilter("WAV audio (*.wav)");
+  filedialog->setDefaultSuffix("wav");
+
+  if (filedialog->exec() == QDialog::Accepted)
+    P->valFilename->setText(filedialog->selectedFiles().front());
+
+  delete filedialog;
+}
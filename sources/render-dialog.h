@@ -0,0 +1,24 @@
+#pragma once
+#include <QDialog>
+#include <memory>
+
+struct OfflineRender;
+
+class RenderDialog : public QDialog {
+  Q_OBJECT;
+ public:
+  explicit RenderDialog(QWidget *parent = nullptr);
+  ~RenderDialog();
+
+  OfflineRender renderSettings() const;
+  int renderSampleFormat() const;
+  QString waveFilename() const;
+
+ public slots:
+  void chooseFile();
+  void accept() override;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> P;
+};
@@ -0,0 +1,209 @@
+#include "riff-wave.h"
+#include "math-dsp.h"
+#include <ostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+
+static void put_u16(std::vector<char> &buf, uint16_t x) {
+  buf.push_back(char(x & 0xff));
+  buf.push_back(char(x >> 8));
+}
+
+static void put_u32(std::vector<char> &buf, uint32_t x) {
+  for (unsigned i = 0; i < 4; ++i)
+    buf.push_back(char((x >> (8 * i)) & 0xff));
+}
+
+static void put_tag(std::vector<char> &buf, const char *tag) {
+  buf.insert(buf.end(), tag, tag + 4);
+}
+
+static unsigned riff_sample_bytes(RiffSampleFormat format) {
+  return (format == RiffInt24) ? 3 : (format == RiffInt16) ? 2 :
+    (format == RiffUInt8) ? 1 : 4;
+}
+
+static uint64_t riff_data_bytes(size_t frame_count,
+                                unsigned channel_count,
+                                RiffSampleFormat format) {
+  return uint64_t(frame_count) * channel_count * riff_sample_bytes(format);
+}
+
+bool riff_wave_fits(size_t frame_count,
+                    unsigned channel_count,
+                    RiffSampleFormat format) {
+  // the size in the RIFF header counts 48 bytes of headers, and a pad
+  const uint64_t frame_bytes = uint64_t(channel_count) * riff_sample_bytes(format);
+  return frame_bytes != 0 && frame_count <= (UINT32_MAX - 48 - 1) / frame_bytes;
+}
+
+bool write_riff_wave(const float *samples,
+                     size_t frame_count,
+                     unsigned channel_count,
+                     unsigned sample_rate,
+                     RiffSampleFormat format,
+                     std::ostream &out) {
+  if (!riff_wave_fits(frame_count, channel_count, format)) {
+    out.setstate(std::ios::failbit);
+    return false;
+  }
+
+  const bool isfloat = format == RiffFloat32;
+  const unsigned sample_bytes = riff_sample_bytes(format);
+  const uint32_t data_bytes = riff_data_bytes(frame_count, channel_count, format);
+  // chunks are of even size
+  const uint32_t pad_bytes = data_bytes & 1;
+
+  std::vector<char> header;
+  header.reserve(64);
+  put_tag(header, "RIFF");
+  put_u32(header, 4 + (8 + 16) + (isfloat ? 8 + 4 : 0) + (8 + data_bytes + pad_bytes));
+  put_tag(header, "WAVE");
+
+  put_tag(header, "fmt ");
+  put_u32(header, 16);
+  put_u16(header, isfloat ? 3 : 1);  // WAVE_FORMAT_IEEE_FLOAT, WAVE_FORMAT_PCM
+  put_u16(header, channel_count);
+  put_u32(header, sample_rate);
+  put_u32(header, sample_rate * channel_count * sample_bytes);
+  put_u16(header, channel_count * sample_bytes);
+  put_u16(header, 8 * sample_bytes);
+
+  // required for formats other than PCM
+  if (isfloat) {
+    put_tag(header, "fact");
+    put_u32(header, 4);
+    put_u32(header, frame_count);
+  }
+
+  put_tag(header, "data");
+  put_u32(header, data_bytes);
+  out.write(header.data(), header.size());
+
+  // little-endian samples, converted in chunks
+  const size_t chunk = 8192;
+  std::vector<char> buf;
+  buf.reserve(chunk * sample_bytes);
+  const size_t sample_count = frame_count * channel_count;
+  for (size_t i = 0; i < sample_count && out; i += chunk) {
+    size_t n = std::min(chunk, sample_count - i);
+    buf.clear();
+    for (size_t j = 0; j < n; ++j) {
+      float s = samples[i + j];
+      if (isfloat) {
+        uint32_t bits;
+        static_assert(sizeof(bits) == sizeof(s), "unexpected size of float");
+        std::copy((const char *)&s, (const char *)&s + 4, (char *)&bits);
+        put_u32(buf, bits);
+        continue;
+      }
+      s = std::isfinite(s) ? std::max(-1.0f, std::min(1.0f, s)) : 0.0f;
+      if (format == RiffInt16) {
+        put_u16(buf, uint16_t(int16_t(std::lround(s * INT16_MAX))));
+      } else if (format == RiffInt24) {
+        uint32_t x = uint32_t(int32_t(std::lround(s * 8388607.0f)));
+        put_u16(buf, uint16_t(x & 0xffff));
+        buf.push_back(char((x >> 16) & 0xff));
+      } else {
+        buf.push_back(char(uint8_t(std::lround(s * INT8_MAX) + 128)));
+      }
+    }
+    out.write(buf.data(), buf.size());
+  }
+  if (pad_bytes)
+    out.put('\0');
+
+  return bool(out);
+}
+
+static uint16_t get_u16(const unsigned char *p) {
+  return uint16_t(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const unsigned char *p) {
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+bool read_riff_wave(const void *data, size_t size, RiffWaveView &view) {
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  const unsigned char *const end = p + size;
+  if (size < 12 || memcmp(p, "RIFF", 4) || memcmp(p + 8, "WAVE", 4))
+    return false;
+  p += 12;
+
+  const unsigned char *fmt = nullptr;
+  size_t fmt_size = 0;
+  while (end - p >= 8) {
+    const unsigned char *chunk = p + 8;
+    size_t chunk_size = std::min<size_t>(get_u32(p + 4), end - chunk);
+
+    if (!memcmp(p, "fmt ", 4) && chunk_size >= 16) {
+      fmt = chunk;
+      fmt_size = chunk_size;
+    } else if (!memcmp(p, "data", 4)) {
+      if (!fmt)
+        return false;
+
+      unsigned tag = get_u16(fmt);
+      unsigned channel_count = get_u16(fmt + 2);
+      unsigned bits = get_u16(fmt + 14);
+      // WAVE_FORMAT_EXTENSIBLE, of which the subformat has the tag
+      if (tag == 0xfffe && fmt_size >= 40)
+        tag = get_u16(fmt + 24);
+
+      // WAVE_FORMAT_PCM, WAVE_FORMAT_IEEE_FLOAT
+      if (tag == 1 && bits == 16) view.format = RiffInt16;
+      else if (tag == 1 && bits == 24) view.format = RiffInt24;
+      else if (tag == 1 && bits == 8) view.format = RiffUInt8;
+      else if (tag == 3 && bits == 32) view.format = RiffFloat32;
+      else return false;
+
+      if (channel_count == 0)
+        return false;
+      view.channel_count = channel_count;
+      view.sample_rate = get_u32(fmt + 4);
+      view.frame_count = chunk_size / (channel_count * (bits / 8));
+      view.data = chunk;
+      return true;
+    }
+
+    p = chunk + chunk_size + (chunk_size & 1);
+  }
+  return false;
+}
+
+void read_riff_samples(const RiffWaveView &view, unsigned channel,
+                       size_t first, size_t count, float *out) {
+  const unsigned sample_bytes = riff_sample_bytes(view.format);
+  const size_t stride = view.channel_count * sample_bytes;
+  const unsigned char *p = view.data + first * stride + channel * sample_bytes;
+
+  // the integers as they are, then scaled to [-1, 1]
+  switch (view.format) {
+  case RiffFloat32:
+    for (size_t i = 0; i < count; ++i, p += stride) {
+      uint32_t bits = get_u32(p);
+      memcpy(&out[i], &bits, 4);
+    }
+    normalize_samples(out, count, 1.0f);
+    break;
+  case RiffInt16:
+    for (size_t i = 0; i < count; ++i, p += stride)
+      out[i] = int16_t(get_u16(p));
+    normalize_samples(out, count, INT16_MAX);
+    break;
+  case RiffInt24:
+    for (size_t i = 0; i < count; ++i, p += stride)
+      out[i] = int32_t((uint32_t(p[0]) << 8) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 24)) >> 8;
+    normalize_samples(out, count, 8388607.0f);
+    break;
+  case RiffUInt8:
+    for (size_t i = 0; i < count; ++i, p += stride)
+      out[i] = int(p[0]) - 128;
+    normalize_samples(out, count, INT8_MAX);
+    break;
+  }
+}
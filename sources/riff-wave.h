@@ -0,0 +1,47 @@
+#pragma once
+#include <iosfwd>
+#include <cstddef>
+
+// RIFF WAVE files
+enum RiffSampleFormat {
+  RiffFloat32,
+  RiffInt16,
+  RiffInt24,
+  RiffUInt8,
+};
+
+#define RIFF_SAMPLE_FORMAT_NAMES                \
+  {"32-bit float", "16-bit signed integer",     \
+   "24-bit signed integer", "8-bit unsigned integer"}
+
+// whether the samples fit in the 4 GiB a RIFF file can address
+bool riff_wave_fits(size_t frame_count,
+                    unsigned channel_count,
+                    RiffSampleFormat format);
+
+// writes interleaved frames, returns false on failure of the stream
+//   Samples which do not fit fail the stream, without writing.
+bool write_riff_wave(const float *samples,
+                     size_t frame_count,
+                     unsigned channel_count,
+                     unsigned sample_rate,
+                     RiffSampleFormat format,
+                     std::ostream &out);
+
+// the samples of a RIFF WAVE file in memory, in place
+struct RiffWaveView {
+  RiffSampleFormat format;
+  unsigned channel_count;
+  unsigned sample_rate;
+  size_t frame_count;
+  const unsigned char *data;
+};
+
+// finds the format and the samples, false if not a file of a known format
+//   A data chunk longer than the file, as left by a writer which did not
+//   finish, is cut to the end of the file.
+bool read_riff_wave(const void *data, size_t size, RiffWaveView &view);
+
+// converts `count` frames from `first` of a channel, to floats in [-1, 1]
+void read_riff_samples(const RiffWaveView &view, unsigned channel,
+                       size_t first, size_t count, float *out);
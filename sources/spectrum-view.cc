@@ -0,0 +1,96 @@
+#include "spectrum-view.h"
+#include "harmonic-spectrum.h"
+#include <QPainter>
+#include <cmath>
+
+struct SpectrumView::Impl {
+  explicit Impl(unsigned harmonics) : spectrum(harmonics) {}
+
+  HarmonicSpectrum spectrum;
+  // the data the spectrum is of
+  std::vector<double> data;
+  std::vector<unsigned> changed;
+};
+
+// the range of magnitudes shown
+static const double floor_db = -72.0;
+
+SpectrumView::SpectrumView(unsigned harmonics, QWidget *parent)
+  : QWidget(parent), P(new Impl(harmonics)) {
+}
+
+SpectrumView::~SpectrumView() {
+}
+
+QSize SpectrumView::sizeHint() const {
+  return QSize(4 * 64 + 2, 256);
+}
+
+void SpectrumView::setData(const std::vector<double> &data) {
+  const unsigned size = data.size();
+
+  bool incremental = size == P->data.size();
+  if (incremental) {
+    // a product per harmonic for each changed sample, against a transform
+    P->changed.clear();
+    for (unsigned i = 0; i < size; ++i) {
+      if (data[i] != P->data[i])
+        P->changed.push_back(i);
+    }
+    double cost = double(P->changed.size()) * P->spectrum.harmonics();
+    incremental = cost < 4.0 * size * std::log2(size + 1);
+  }
+
+  if (incremental) {
+    for (unsigned i : P->changed) {
+      P->spectrum.update(i, P->data[i], data[i]);
+      P->data[i] = data[i];
+    }
+  } else {
+    P->data = data;
+    P->spectrum.reset(data.data(), size);
+  }
+
+  this->update();
+}
+
+void SpectrumView::paintEvent(QPaintEvent *event) {
+  QPainter painter(this);
+  painter.fillRect(this->rect(), Qt::black);
+
+  const HarmonicSpectrum &spectrum = P->spectrum;
+  const unsigned count = spectrum.harmonics();
+  if (count == 0)
+    return;
+
+  // magnitudes above, phases below
+  const int w = this->width();
+  const int h = this->height();
+  const int hmag = h * 3 / 4;
+  const int hphase = h - hmag;
+  const double barw = double(w) / count;
+
+  painter.setPen(Qt::darkGray);
+  for (int db = -12; db > floor_db; db -= 12) {
+    int y = int(hmag * db / floor_db);
+    painter.drawLine(0, y, w - 1, y);
+  }
+  painter.drawLine(0, hmag + hphase / 2, w - 1, hmag + hphase / 2);
+
+  for (unsigned k = 1; k <= count; ++k) {
+    double amp = spectrum.amplitude(k);
+    double db = (amp > 0) ? 20.0 * std::log10(amp) : floor_db;
+    db = (db < floor_db) ? floor_db : (db > 0.0) ? 0.0 : db;
+
+    int x1 = int((k - 1) * barw);
+    int x2 = int(k * barw) - 1;
+    int y = int(hmag * db / floor_db);
+    painter.fillRect(QRect(QPoint(x1, y), QPoint(std::max(x1, x2 - 1), hmag - 1)), Qt::red);
+
+    if (db > floor_db) {
+      double phase = spectrum.phase(k) / M_PI;  // in [-1, 1]
+      int yp = hmag + int((1.0 - phase) * 0.5 * (hphase - 1));
+      painter.fillRect(QRect(x1, yp - 1, std::max(1, x2 - x1), 3), Qt::white);
+    }
+  }
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <QWidget>
+#include <vector>
+#include <memory>
+
+// magnitudes and phases of the harmonics of the table being edited
+//   Given the new data, it updates the spectrum by the samples which
+//   differ, and transforms anew only when many do.
+class SpectrumView : public QWidget {
+  Q_OBJECT;
+ public:
+  explicit SpectrumView(unsigned harmonics = 64, QWidget *parent = nullptr);
+  ~SpectrumView();
+
+  QSize sizeHint() const override;
+  void paintEvent(QPaintEvent *event) override;
+
+ public slots:
+  void setData(const std::vector<double> &data);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> P;
+};
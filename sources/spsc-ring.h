@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+
+// lock-free ring buffer for one producer thread and one consumer thread
+//   The capacity is rounded up to a power of 2. Neither side allocates
+//   after construction.
+template <class T>
+class SpscRing {
+ public:
+  explicit SpscRing(size_t capacity);
+
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  size_t capacity() const { return mask_ + 1; }
+
+  // producer side
+  size_t writeAvailable() const;
+  size_t write(const T *data, size_t count);
+  bool push(const T &item) { return write(&item, 1) == 1; }
+
+  // consumer side
+  size_t readAvailable() const;
+  size_t read(T *data, size_t count);
+  bool pop(T &item) { return read(&item, 1) == 1; }
+
+ private:
+  std::unique_ptr<T[]> buffer_;
+  size_t mask_ {};
+  alignas(64) std::atomic<size_t> head_ {0};  // written by the producer
+  alignas(64) std::atomic<size_t> tail_ {0};  // written by the consumer
+};
+
+template <class T>
+SpscRing<T>::SpscRing(size_t capacity) {
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+  buffer_.reset(new T[size]());
+  mask_ = size - 1;
+}
+
+template <class T>
+size_t SpscRing<T>::writeAvailable() const {
+  size_t head = head_.load(std::memory_order_relaxed);
+  size_t tail = tail_.load(std::memory_order_acquire);
+  return capacity() - (head - tail);
+}
+
+template <class T>
+size_t SpscRing<T>::write(const T *data, size_t count) {
+  size_t head = head_.load(std::memory_order_relaxed);
+  size_t tail = tail_.load(std::memory_order_acquire);
+  count = std::min(count, capacity() - (head - tail));
+
+  size_t start = head & mask_;
+  size_t first = std::min(count, capacity() - start);
+  std::copy(data, data + first, buffer_.get() + start);
+  std::copy(data + first, data + count, buffer_.get());
+
+  head_.store(head + count, std::memory_order_release);
+  return count;
+}
+
+template <class T>
+size_t SpscRing<T>::readAvailable() const {
+  size_t head = head_.load(std::memory_order_acquire);
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  return head - tail;
+}
+
+template <class T>
+size_t SpscRing<T>::read(T *data, size_t count) {
+  size_t head = head_.load(std::memory_order_acquire);
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  count = std::min(count, head - tail);
+
+  size_t start = tail & mask_;
+  size_t first = std::min(count, capacity() - start);
+  std::copy(buffer_.get() + start, buffer_.get() + start + first, data);
+  std::copy(buffer_.get(), buffer_.get() + count - first, data + first);
+
+  tail_.store(tail + count, std::memory_order_release);
+  return count;
+}
@@ -0,0 +1,180 @@
+#include "voice-engine.h"
+#include "wave-table.h"
+#include <algorithm>
+#include <cmath>
+
+VoiceEngine::VoiceEngine(unsigned voiceCount)
+  : voices_(voiceCount), events_(1024),
+    voiceBuffer_(new float[blockSize]) {
+  updateEnvelope();
+}
+
+VoiceEngine::~VoiceEngine() {
+}
+
+void VoiceEngine::setSampleRate(double sampleRate) {
+  sampleRate_ = sampleRate;
+  updateEnvelope();
+}
+
+void VoiceEngine::setEnvelope(double attack, double release) {
+  attack_ = attack;
+  release_ = release;
+  updateEnvelope();
+}
+
+void VoiceEngine::updateEnvelope() {
+  // linear ramps, at least one sample long
+  attackStep_ = 1.0 / std::max(1.0, attack_ * sampleRate_);
+  releaseStep_ = 1.0 / std::max(1.0, release_ * sampleRate_);
+}
+
+bool VoiceEngine::noteOn(int key, double freq) {
+  return events_.push(Event {Event::NoteOn, key, freq});
+}
+
+bool VoiceEngine::noteOff(int key) {
+  return events_.push(Event {Event::NoteOff, key, 0});
+}
+
+bool VoiceEngine::allNotesOff() {
+  return events_.push(Event {Event::AllNotesOff, 0, 0});
+}
+
+bool VoiceEngine::setFrequency(int key, double freq) {
+  return events_.push(Event {Event::SetFrequency, key, freq});
+}
+
+void VoiceEngine::processEvent(const Event &event) {
+  switch (event.type) {
+    case Event::NoteOn: {
+      // retrigger a key which is still held, otherwise take a voice
+      auto it = std::find_if(voices_.begin(), voices_.end(), [&](const Voice &v) {
+        return v.state == Voice::Held && v.key == event.key; });
+      Voice &voice = (it != voices_.end()) ? *it : allocateVoice();
+      if (voice.state == Voice::Off) {
+        voice.phase = 0;
+        voice.env = 0;
+      }
+      voice.state = Voice::Held;
+      voice.key = event.key;
+      voice.freq = event.freq;
+      voice.age = ++noteCounter_;
+      break;
+    }
+    case Event::NoteOff:
+      for (Voice &voice : voices_) {
+        if (voice.state == Voice::Held && voice.key == event.key)
+          voice.state = Voice::Released;
+      }
+      break;
+    case Event::AllNotesOff:
+      for (Voice &voice : voices_) {
+        if (voice.state == Voice::Held)
+          voice.state = Voice::Released;
+      }
+      break;
+    case Event::SetFrequency:
+      for (Voice &voice : voices_) {
+        if (voice.state != Voice::Off && voice.key == event.key)
+          voice.freq = event.freq;
+      }
+      break;
+  }
+}
+
+VoiceEngine::Voice &VoiceEngine::allocateVoice() {
+  // a free voice, or else the quietest released one, or else the oldest
+  Voice *best = nullptr;
+  for (Voice &voice : voices_) {
+    if (voice.state == Voice::Off)
+      return voice;
+    if (!best)
+      best = &voice;
+    else if (voice.state == Voice::Released) {
+      if (best->state != Voice::Released || voice.env < best->env)
+        best = &voice;
+    } else if (best->state != Voice::Released && voice.age < best->age)
+      best = &voice;
+  }
+  return *best;
+}
+
+void VoiceEngine::renderBlock(const MipmapWavetable *table,
+                              InterpolationQuality quality,
+                              double morph,
+                              float *out) {
+  for (Event event; events_.pop(event);)
+    processEvent(event);
+
+  std::fill(out, out + blockSize, 0.0f);
+
+  if (!table || table->levelCount() == 0) {
+    for (Voice &voice : voices_)
+      voice.state = Voice::Off;
+    return;
+  }
+
+  float *buffer = voiceBuffer_.get();
+  const unsigned log2size = table->log2Size();
+
+  // the pair of frames to morph between, and the weights of the second
+  const unsigned frames = table->frameCount();
+  unsigned frame = 0;
+  float weight1 = 0, weight2 = 0;
+  ptrdiff_t stride = 0;
+  if (frames > 1) {
+    double last = frames - 1;
+    double start = std::max(0.0, std::min(last, morph_));
+    double target = std::max(0.0, std::min(last, morph));
+    double end;
+    if (target >= start) {
+      frame = unsigned(start);
+      end = std::min(target, frame + 1.0);
+    } else {
+      frame = unsigned(std::ceil(start)) - 1;
+      end = std::max(target, double(frame));
+    }
+    frame = std::min(frame, frames - 2);
+    weight1 = start - frame;
+    weight2 = end - frame;
+    stride = table->frameStride();
+    morph_ = end;
+  }
+  const float morphstep = (weight2 - weight1) / blockSize;
+
+  for (Voice &voice : voices_) {
+    if (voice.state == Voice::Off)
+      continue;
+
+    MipmapWavetable::Selection sel = table->select(voice.freq, sampleRate_);
+    unsigned nextlevel = sel.level + ((sel.mix > 0) ? 1 : 0);
+    voice.phase = render_wavetable_morph(
+      table->level(sel.level, frame), table->level(nextlevel, frame), sel.mix,
+      stride, weight1, morphstep,
+      log2size, voice.phase, phase_increment(voice.freq, sampleRate_),
+      buffer, blockSize, quality);
+
+    // linear ramps in closed form, free of a loop-carried dependency
+    float env = voice.env;
+    if (voice.state == Voice::Held) {
+      const float step = attackStep_;
+      for (unsigned i = 0; i < blockSize; ++i)
+        out[i] += std::min(1.0f, env + (i + 1) * step) * buffer[i];
+      env = std::min(1.0f, env + blockSize * step);
+    } else {
+      const float step = releaseStep_;
+      for (unsigned i = 0; i < blockSize; ++i)
+        out[i] += std::max(0.0f, env - (i + 1) * step) * buffer[i];
+      env = std::max(0.0f, env - blockSize * step);
+      if (env == 0.0f)
+        voice.state = Voice::Off;
+    }
+    voice.env = env;
+  }
+}
+
+unsigned VoiceEngine::activeVoices() const {
+  return std::count_if(voices_.begin(), voices_.end(), [](const Voice &v) {
+    return v.state != Voice::Off; });
+}
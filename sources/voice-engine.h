@@ -0,0 +1,75 @@
+#pragma once
+#include "spsc-ring.h"
+#include "wave-render.h"
+#include <vector>
+#include <memory>
+
+class MipmapWavetable;
+
+// polyphonic player of one wavetable
+//   Notes are sent from a control thread through a lock-free queue, and
+//   the voices are mixed in fixed-size blocks on the audio thread.
+class VoiceEngine {
+ public:
+  static const unsigned blockSize = 64;
+
+  explicit VoiceEngine(unsigned voiceCount = 32);
+  ~VoiceEngine();
+
+  unsigned voiceCount() const { return voices_.size(); }
+
+  // setup, not while rendering
+  void setSampleRate(double sampleRate);
+  void setEnvelope(double attack, double release);
+
+  // control thread, returns false if the queue is full
+  //   a key identifies a note; it is unrelated to frequency
+  bool noteOn(int key, double freq);
+  bool noteOff(int key);
+  bool allNotesOff();
+  bool setFrequency(int key, double freq);
+
+  // audio thread, renders `blockSize` frames
+  //   The morph position, in frames of the table, glides towards `morph`
+  //   moving at most to the next frame in a block.
+  void renderBlock(const MipmapWavetable *table,
+                   InterpolationQuality quality,
+                   double morph,
+                   float *out);
+
+  // audio thread
+  unsigned activeVoices() const;
+
+ private:
+  struct Event {
+    enum Type { NoteOn, NoteOff, AllNotesOff, SetFrequency };
+    Type type;
+    int key;
+    double freq;
+  };
+
+  struct Voice {
+    enum State { Off, Held, Released };
+    State state = Off;
+    int key {};
+    double freq {};
+    uint32_t phase {};
+    float env {};
+    unsigned long long age {};
+  };
+
+  void processEvent(const Event &event);
+  Voice &allocateVoice();
+  void updateEnvelope();
+
+  std::vector<Voice> voices_;
+  SpscRing<Event> events_;
+  double sampleRate_ = 44100.0;
+  double attack_ = 0.005;
+  double release_ = 0.2;
+  float attackStep_ {};
+  float releaseStep_ {};
+  unsigned long long noteCounter_ {};
+  double morph_ {};
+  std::unique_ptr<float[]> voiceBuffer_;
+};
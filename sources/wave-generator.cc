@@ -1,73 +1,257 @@
 #include "wave-generator.h"
+#include "wave-table.h"
+#include <QAudioFormat>
+#include <QSysInfo>
 #include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
 
-static const int channel_count = 1;
+// the key of the play button's tone, apart from keyboard notes
+static const int play_key = -1;
 
 WaveGenerator::WaveGenerator(QObject *parent)
   : QIODevice(parent) {
 }
 
-void WaveGenerator::start(int bufferSize, int sampleRate) {
-  this->open(QIODevice::ReadOnly);
-  wavePos_ = 0;
-  bufferSize_ = bufferSize;
+WaveGenerator::~WaveGenerator() {
+  stop();
+}
+
+void WaveGenerator::start(int sampleRate, unsigned period, unsigned periods) {
+  stop();
+
+  // periods are made of whole blocks of the voice engine
+  const unsigned block_size = VoiceEngine::blockSize;
+  period = std::max(block_size, (period + block_size - 1) / block_size * block_size);
+  periods = std::max(2u, periods);
+
   sampleRate_ = sampleRate;
+  period_ = period;
+  periods_ = periods;
+  voices_.setSampleRate(sampleRate);
+  ring_.reset(new SpscRing<float>(period * periods));
+  stats_.reset();
+
+  if (!this->isOpen())
+    this->open(QIODevice::ReadOnly);
+
+  running_ = true;
+  renderThread_ = std::thread([this]() { renderLoop(); });
 }
 
 void WaveGenerator::stop() {
-  wavePos_ = 0;
-  bufferSize_ = {};
-  sampleRate_ = {};
+  running_ = false;
+  if (renderThread_.joinable())
+    renderThread_.join();
 }
 
-qint64 WaveGenerator::readData(char *data, qint64 len) {
-  float *output_buffer = (float *)data;
-  const int frame_count = len / channel_count / sizeof(float);
-
-  const std::vector<double> *wavetable = wavetable_;
-  if (!wavetable) {
-    std::fill(output_buffer, output_buffer + frame_count * channel_count, 0);
-  } else {
-    const double *wave = wavetable->data();
-    int wavelen = wavetable->size();
-    double wavepos = wavePos_;
-    double increment = freq_ / sampleRate_;
-    for (int i = 0; i < frame_count; ++i) {
-      double index = wavepos * (wavelen - 1);
-
-      int i1 = index;
-      int i2 = (i1 + 1) % wavelen;
-      double mu = index - i1;
-
-      // linear interpolation
-      double s = wave[i1] + mu * (wave[i2] - wave[i1]);
-
-      for (int c = 0; c < channel_count; ++c)
-        output_buffer[i * channel_count + c] = s;
-
-      wavepos += increment;
-      while (wavepos > 1.0)
-        wavepos -= 1.0;
+static uint64_t elapsed_nanos(std::chrono::steady_clock::time_point since) {
+  auto elapsed = std::chrono::steady_clock::now() - since;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void WaveGenerator::renderLoop() {
+  const unsigned block_size = VoiceEngine::blockSize;
+  const unsigned period = period_;
+  const unsigned capacity = period * periods_;
+  std::unique_ptr<float[]> buffer(new float[period]);
+
+  // poll a few times per period for room in the ring
+  const std::chrono::microseconds wait(
+    (long long)(0.25e6 * period / sampleRate_));
+
+  while (running_) {
+    if (ring_->readAvailable() + period > capacity) {
+      std::this_thread::sleep_for(wait);
+      continue;
     }
-    wavePos_ = wavepos;
+
+    auto time = std::chrono::steady_clock::now();
+
+    const MipmapWavetable *wavetable = wavetable_.acquire();
+    const InterpolationQuality quality = InterpolationQuality(quality_.load());
+    const double morph = morph_.load();
+    for (unsigned i = 0; i < period; i += block_size)
+      voices_.renderBlock(wavetable, quality, morph, &buffer[i]);
+    wavetable_.release();
+
+    ring_->write(buffer.get(), period);
+
+    stats_.recordRender(elapsed_nanos(time), period);
   }
+}
+
+template <class Sample> static Sample convert_sample(float x);
 
-  return frame_count * channel_count * sizeof(float);
+template <> float convert_sample<float>(float x) {
+  return x;
 }
 
-// qint64 WaveGenerator::bytesAvailable() const {
-//   qint64 avail = bufferSize_ * channel_count * sizeof(float);
-//   return avail;
-// }
+template <> int16_t convert_sample<int16_t>(float x) {
+  x = (x < -1.0f) ? -1.0f : (x > 1.0f) ? 1.0f : x;
+  return int16_t(std::lrint(x * INT16_MAX));
+}
+
+template <> int32_t convert_sample<int32_t>(float x) {
+  double d = (x < -1.0f) ? -1.0 : (x > 1.0f) ? 1.0 : x;
+  return int32_t(std::lrint(d * INT32_MAX));
+}
+
+template <class Sample, unsigned Channels>
+qint64 WaveGenerator::readFrames(char *data, qint64 len, unsigned &silent) {
+  Sample *output_buffer = (Sample *)data;
+  const unsigned frame_count = len / (Channels * sizeof(Sample));
+
+  // mono from the ring, to interleaved frames of the device
+  const unsigned chunk_size = 256;
+  float chunk[chunk_size];
+
+  for (unsigned i = 0; i < frame_count;) {
+    unsigned count = std::min(chunk_size, frame_count - i);
+    unsigned avail = ring_ ? ring_->read(chunk, count) : 0;
+
+    // on underrun, output silence and keep the stream going
+    std::fill(chunk + avail, chunk + count, 0.0f);
+    silent += count - avail;
+
+    for (unsigned j = 0; j < count; ++j) {
+      Sample s = convert_sample<Sample>(chunk[j]);
+      for (unsigned c = 0; c < Channels; ++c)
+        output_buffer[(i + j) * Channels + c] = s;
+    }
+    i += count;
+  }
+
+  return frame_count * Channels * sizeof(Sample);
+}
+
+bool WaveGenerator::setOutputFormat(const QAudioFormat &format) {
+  read_ = nullptr;
+  frameBytes_ = format.bytesPerFrame();
+
+  if (format.codec() != "audio/pcm" ||
+      format.byteOrder() != QAudioFormat::Endian(QSysInfo::ByteOrder))
+    return false;
+
+  unsigned channels = format.channelCount();
+  int bits = format.sampleSize();
+
+  switch (format.sampleType()) {
+    case QAudioFormat::Float:
+      if (bits == 32 && channels == 1)
+        read_ = &WaveGenerator::readFrames<float, 1>;
+      else if (bits == 32 && channels == 2)
+        read_ = &WaveGenerator::readFrames<float, 2>;
+      break;
+    case QAudioFormat::SignedInt:
+      if (bits == 16 && channels == 1)
+        read_ = &WaveGenerator::readFrames<int16_t, 1>;
+      else if (bits == 16 && channels == 2)
+        read_ = &WaveGenerator::readFrames<int16_t, 2>;
+      else if (bits == 32 && channels == 1)
+        read_ = &WaveGenerator::readFrames<int32_t, 1>;
+      else if (bits == 32 && channels == 2)
+        read_ = &WaveGenerator::readFrames<int32_t, 2>;
+      break;
+    default:
+      break;
+  }
+
+  return read_ != nullptr;
+}
+
+qint64 WaveGenerator::readData(char *data, qint64 len) {
+  if (!read_) {
+    std::fill(data, data + len, 0);
+    return len;
+  }
+
+  auto time = std::chrono::steady_clock::now();
+  unsigned silent = 0;
+  qint64 bytes = (this->*read_)(data, len, silent);
+  stats_.recordRead(elapsed_nanos(time), bytes / frameBytes_, silent);
+
+  return bytes;
+}
 
 qint64 WaveGenerator::writeData(const char *data, qint64 len) {
   return 0;
 }
 
-void WaveGenerator::setWavetable(const std::vector<double> &table) {
-  wavetable_ = &table;
+unsigned WaveGenerator::bufferedFrames() const {
+  return ring_ ? ring_->readAvailable() : 0;
+}
+
+void WaveGenerator::setWavetable(const std::vector<double> &table, unsigned frame) {
+  const MipmapWavetable *current = wavetable_.published();
+
+  if (frames_.empty() || frames_[0].size() != table.size()) {
+    // a table of another size replaces all the frames
+    frames_.assign(std::max<size_t>(1, frames_.size()), table);
+    rebuildWavetable();
+    return;
+  }
+
+  if (frame >= frames_.size())
+    return;
+  frames_[frame] = table;
+
+  // take an immutable snapshot, band-limited once per change of frame;
+  // the one it replaces is deleted here, never on the audio thread
+  std::unique_ptr<const MipmapWavetable> wavetable(
+    new MipmapWavetable(*current, frame, table.data()));
+  wavetable_.publish(std::move(wavetable));
+}
+
+void WaveGenerator::setFrameCount(unsigned count) {
+  count = std::max(1u, count);
+  if (frames_.empty() || count == frames_.size())
+    return;
+  // new frames start as copies of the last
+  frames_.resize(count, frames_.back());
+  rebuildWavetable();
+}
+
+void WaveGenerator::rebuildWavetable() {
+  const unsigned size = frames_[0].size();
+  std::vector<double> bank(size * frames_.size());
+  for (size_t f = 0; f < frames_.size(); ++f)
+    std::copy(frames_[f].begin(), frames_[f].end(), &bank[f * size]);
+
+  std::unique_ptr<const MipmapWavetable> wavetable(
+    new MipmapWavetable(bank.data(), size, frames_.size()));
+  wavetable_.publish(std::move(wavetable));
+}
+
+void WaveGenerator::setMorph(double position) {
+  morph_ = position;
+}
+
+void WaveGenerator::setInterpolation(InterpolationQuality quality) {
+  quality_ = quality;
+}
+
+void WaveGenerator::play() {
+  voices_.noteOff(play_key);
+  voices_.noteOn(play_key, freq_);
 }
 
 void WaveGenerator::setFrequency(double freq) {
   freq_ = freq;
+  voices_.setFrequency(play_key, freq);
+}
+
+void WaveGenerator::noteOn(int note) {
+  double freq = 440.0 * std::exp2((note - 69) / 12.0);
+  voices_.noteOn(note, freq);
+}
+
+void WaveGenerator::noteOff(int note) {
+  voices_.noteOff(note);
+}
+
+void WaveGenerator::allNotesOff() {
+  voices_.allNotesOff();
 }
@@ -1,26 +1,86 @@
 #pragma once
+#include "audio-stats.h"
+#include "rcu-cell.h"
+#include "spsc-ring.h"
+#include "wave-render.h"
+#include "voice-engine.h"
 #include <QIODevice>
+#include <thread>
+#include <atomic>
 
+class MipmapWavetable;
+class QAudioFormat;
+
+// plays the voices to the audio device
+//   A render thread writes periods of fixed size into a lock-free ring,
+//   kept filled to a number of periods, which the device reads from.
+//   The device reads in its own sample format and channel count, by an
+//   instance of the reader chosen once for the format.
 class WaveGenerator : public QIODevice {
   Q_OBJECT;
 
  public:
   explicit WaveGenerator(QObject *parent = nullptr);
-  void start(int bufferSize, int sampleRate);
+  ~WaveGenerator();
+
+  // picks the reader of the device format, false if it has none
+  bool setOutputFormat(const QAudioFormat &format);
+
+  void start(int sampleRate, unsigned period, unsigned periods);
   void stop();
 
   qint64 readData(char *data, qint64 len) override;
   qint64 writeData(const char *data, qint64 len) override;
 
-  // qint64 bytesAvailable() const override;
+  // frames rendered in advance of the device
+  unsigned bufferedFrames() const;
+  int sampleRate() const { return sampleRate_; }
+
+  // counters of the audio and render threads
+  AudioStats &stats() { return stats_; }
+
+  // the frames of the wavetable, morphed by position
+  //   Setting a frame rebuilds only that frame of the band-limited table.
+  void setWavetable(const std::vector<double> &table, unsigned frame = 0);
+  void setFrameCount(unsigned count);
+  unsigned frameCount() const { return frames_.size(); }
+  const std::vector<double> &frameData(unsigned frame) const { return frames_[frame]; }
+  void setMorph(double position);
 
-  void setWavetable(const std::vector<double> &table);
+  void setInterpolation(InterpolationQuality quality);
+
+  // the held tone of the play button
+  void play();
   void setFrequency(double freq);
 
+  // notes of the keyboard, by MIDI number
+  void noteOn(int note);
+  void noteOff(int note);
+  void allNotesOff();
+
  private:
-  int bufferSize_ {};
+  void renderLoop();
+  void rebuildWavetable();
+
+  // counts the frames the ring lacked into `silent`
+  template <class Sample, unsigned Channels>
+  qint64 readFrames(char *data, qint64 len, unsigned &silent);
+
+  typedef qint64 (WaveGenerator::*ReadFunction)(char *data, qint64 len, unsigned &silent);
+  ReadFunction read_ {};
+  unsigned frameBytes_ {};
+
   int sampleRate_ {};
-  const std::vector<double> *wavetable_;
-  double wavePos_ {};
+  unsigned period_ {};
+  unsigned periods_ {};
+  RcuCell<MipmapWavetable> wavetable_;
+  std::vector<std::vector<double>> frames_;
+  std::atomic<double> morph_ {0.0};
+  VoiceEngine voices_;
+  std::unique_ptr<SpscRing<float>> ring_;
+  std::thread renderThread_;
+  std::atomic<bool> running_ {false};
   double freq_ = 220.0;
+  std::atomic<int> quality_ {InterpHermite};
+  AudioStats stats_;
 };
@@ -14,6 +14,16 @@
 static const QStringList namefilters = WAVE_FORMAT_NAME_FILTERS;
 static const QStringList suffixes = WAVE_FORMAT_SUFFIXES;
 static const QStringList datatypenames = WAVE_DATA_TYPE_NAMES;
+static const QStringList resamplenames = RESAMPLE_QUALITY_NAMES;
+
+static QComboBox *new_resample_quality_box() {
+  QComboBox *box = new QComboBox;
+  for (int i = 0; i < resamplenames.size(); ++i)
+    box->addItem(resamplenames[i], ResampleQuality(i));
+  // exact for tables, and fast enough for files
+  box->setCurrentIndex(box->findData(ResamplePeriodic));
+  return box;
+}
 ///
 
 struct WaveSaveDialog::Impl {
@@ -21,6 +31,7 @@ struct WaveSaveDialog::Impl {
   QLineEdit *valFilename {};
   QComboBox *selOutputFormat {};
   QComboBox *selOutputType {};
+  QComboBox *selResampleQuality {};
 };
 
 WaveSaveDialog::WaveSaveDialog(QWidget *parent)
@@ -57,6 +68,9 @@ WaveSaveDialog::WaveSaveDialog(QWidget *parent)
   }
   form->addRow("Output type", P->selOutputType);
 
+  P->selResampleQuality = new_resample_quality_box();
+  form->addRow("Resampling", P->selResampleQuality);
+
   QDialogButtonBox *buttonbox = new QDialogButtonBox(
     QDialogButtonBox::Save|QDialogButtonBox::Cancel);
   layout->addWidget(buttonbox);
@@ -85,6 +99,10 @@ int WaveSaveDialog::waveOutputSize() const {
   return P->valOutputSize->value();
 }
 
+int WaveSaveDialog::waveResampleQuality() const {
+  return ResampleQuality(P->selResampleQuality->currentData().toInt());
+}
+
 QString WaveSaveDialog::waveFilename() const {
   return P->valFilename->text();
 }
@@ -114,6 +132,9 @@ struct WaveOpenDialog::Impl {
   QLineEdit *valFilename {};
   QComboBox *selInputFormat {};
   QSpinBox *valInputChannel {};
+  QSpinBox *valFrameLength {};
+  QSpinBox *valFrame {};
+  QComboBox *selResampleQuality {};
 };
 
 WaveOpenDialog::WaveOpenDialog(QWidget *parent)
@@ -143,6 +164,21 @@ WaveOpenDialog::WaveOpenDialog(QWidget *parent)
   P->valInputChannel->setValue(0);
   form->addRow("Input channel", P->valInputChannel);
 
+  // banks of tables, as wavetables of other synthesizers
+  P->valFrameLength = new QSpinBox;
+  P->valFrameLength->setRange(0, 1 << 20);
+  P->valFrameLength->setSpecialValueText("Whole channel");
+  P->valFrameLength->setValue(0);
+  form->addRow("Frame length", P->valFrameLength);
+
+  P->valFrame = new QSpinBox;
+  P->valFrame->setRange(0, 65535);
+  P->valFrame->setValue(0);
+  form->addRow("Frame", P->valFrame);
+
+  P->selResampleQuality = new_resample_quality_box();
+  form->addRow("Resampling", P->selResampleQuality);
+
   QDialogButtonBox *buttonbox = new QDialogButtonBox(
     QDialogButtonBox::Open|QDialogButtonBox::Cancel);
   layout->addWidget(buttonbox);
@@ -167,6 +203,18 @@ unsigned WaveOpenDialog::waveInputChannel() const {
   return P->valInputChannel->value();
 }
 
+unsigned WaveOpenDialog::waveFrameLength() const {
+  return P->valFrameLength->value();
+}
+
+unsigned WaveOpenDialog::waveFrame() const {
+  return P->valFrame->value();
+}
+
+int WaveOpenDialog::waveResampleQuality() const {
+  return ResampleQuality(P->selResampleQuality->currentData().toInt());
+}
+
 QString WaveOpenDialog::waveFilename() const {
   return P->valFilename->text();
 }
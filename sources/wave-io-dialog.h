@@ -11,6 +11,7 @@ class WaveSaveDialog : public QDialog {
   int waveOutputFormat() const;
   int waveOutputDataType() const;
   int waveOutputSize() const;
+  int waveResampleQuality() const;
   QString waveFilename() const;
 
  public slots:
@@ -30,6 +31,9 @@ class WaveOpenDialog : public QDialog {
 
   int waveInputFormat() const;
   unsigned waveInputChannel() const;
+  unsigned waveFrameLength() const;
+  unsigned waveFrame() const;
+  int waveResampleQuality() const;
   QString waveFilename() const;
 
  public slots:
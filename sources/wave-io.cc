@@ -1,53 +1,226 @@
 #include "wave-io.h"
-#include <boost/algorithm/string.hpp>
-#include <boost/iostreams/copy.hpp>
+#include "math-dsp.h"
+#include "riff-wave.h"
+#include <boost/scope_exit.hpp>
 #include <iostream>
-#include <sstream>
+#include <fstream>
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <cassert>
+#include <memory>
+#if defined(DESSINER_HAVE_MMAP)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
-static int sat16(int x) {
-  return (x < INT16_MIN) ? INT16_MIN : (x > INT16_MAX) ? INT16_MAX : x;
-}
-static int sat8(int x) {
-  return (x < INT8_MIN) ? INT8_MIN : (x > INT8_MAX) ? INT8_MAX : x;
-}
-
-static float satfloat(float x) {
-  if (!std::isfinite(x))
-    return 0.0f;
-  return (x < -1.0f) ? -1.0f : (x > 1.0f) ? 1.0f : x;
-}
+// the largest of 24-bit samples, as INT16_MAX
+static constexpr int32_t int24_max = (1 << 23) - 1;
 
 static void convert_to_float(float *samples,
                              unsigned sample_count,
                              WaveDataType type) {
-  for (unsigned i = 0; i < sample_count; ++i) {
-    float s = samples[i];
-    switch (type) {
-     case WaveFloat: break;
-     case WaveInt16: s /= INT16_MAX; break;
-     case WaveInt8: s /= INT8_MAX; break;
-     default: assert(false);
-    }
-    samples[i] = satfloat(s);
+  switch (type) {
+   case WaveFloat: normalize_samples(samples, sample_count, 1.0f); break;
+   case WaveInt16: normalize_samples(samples, sample_count, INT16_MAX); break;
+   case WaveInt8: normalize_samples(samples, sample_count, INT8_MAX); break;
+   case WaveInt24: normalize_samples(samples, sample_count, int24_max); break;
+   default: assert(false);
   }
 }
 
 static void convert_from_float(float *samples,
                                unsigned sample_count,
                                WaveDataType type) {
-  for (unsigned i = 0; i < sample_count; ++i) {
-    float s = samples[i];
-    switch (type) {
-    case WaveFloat: s = satfloat(s); break;
-    case WaveInt16: s = sat16(std::lround(samples[i] * INT16_MAX)); break;
-    case WaveInt8: s = sat8(std::lround(samples[i] * INT8_MAX)); break;
-    default: assert(false);
+  switch (type) {
+  case WaveFloat: normalize_samples(samples, sample_count, 1.0f); break;
+  case WaveInt16: quantize_samples(samples, sample_count, INT16_MAX); break;
+  case WaveInt8: quantize_samples(samples, sample_count, INT8_MAX); break;
+  case WaveInt24: quantize_samples(samples, sample_count, int24_max); break;
+  default: assert(false);
+  }
+}
+
+// mantissa * 10^exponent, as the readers convert it
+//   Exact operands give a correctly rounded result, others nearly.
+static double decimal_value(uint64_t mantissa, int exponent) {
+  static const double powers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+  if (mantissa == 0)
+    return 0;
+  if (mantissa < (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+    return (exponent < 0) ? mantissa / powers[-exponent] : mantissa * powers[exponent];
+  if (exponent < 0)
+    return double(mantissa / std::pow(10.0L, -exponent));
+  return double(mantissa * std::pow(10.0L, exponent));
+}
+
+// text output through a large buffer, independent of the locale
+class TextWriter {
+public:
+  explicit TextWriter(std::ostream &out)
+    : out_(out), buffer_(new char[capacity]) {}
+
+  void put(char c) {
+    reserve(1);
+    buffer_[size_++] = c;
+  }
+
+  void put(const char *text) {
+    for (size_t n = strlen(text); n > 0;) {
+      reserve(1);
+      size_t m = std::min(n, capacity - size_);
+      memcpy(&buffer_[size_], text, m);
+      size_ += m;
+      text += m;
+      n -= m;
+    }
+  }
+
+  void putInteger(long value) {
+    reserve(24);
+    unsigned long magnitude = value;
+    if (value < 0) {
+      buffer_[size_++] = '-';
+      magnitude = 0ul - magnitude;
+    }
+    size_ += write_digits(&buffer_[size_], magnitude);
+  }
+
+  // the shortest decimal which reads back as the same float
+  void putFloat(float value);
+
+  void flush() {
+    out_.write(buffer_.get(), size_);
+    size_ = 0;
+  }
+
+private:
+  static constexpr size_t capacity = 1 << 16;
+
+  void reserve(size_t n) {
+    if (size_ + n > capacity)
+      flush();
+  }
+
+  static unsigned write_digits(char *text, uint64_t value) {
+    char digits[20];
+    unsigned count = 0;
+    do {
+      digits[count++] = char('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    for (unsigned i = 0; i < count; ++i)
+      text[i] = digits[count - 1 - i];
+    return count;
+  }
+
+  std::ostream &out_;
+  std::unique_ptr<char[]> buffer_;
+  size_t size_ = 0;
+};
+
+void TextWriter::putFloat(float value) {
+  reserve(24);
+  char *text = &buffer_[size_];
+  char *p = text;
+
+  if (std::signbit(value))
+    *p++ = '-';
+  float magnitude = std::fabs(value);
+  if (magnitude == 0 || !std::isfinite(magnitude)) {
+    // not something to read back, as the samples are normalized
+    *p++ = '0';
+    size_ += p - text;
+    return;
+  }
+
+  // 10^k for the scales of floats, nearest in double
+  static const struct Powers {
+    double value[120];
+    Powers() { for (int k = 0; k < 120; ++k) value[k] = double(std::pow(10.0L, k - 60)); }
+    double operator()(int k) const { return value[k + 60]; }
+  } power;
+
+  // the decimal exponent of the leading digit
+  //   from the binary exponent, as log10(2) = 0.30103 = 78913 / 2^18
+  int binary;
+  std::frexp(magnitude, &binary);
+  int lead = ((binary - 1) * 78913) >> 18;
+  if (power(lead + 1) <= magnitude)
+    ++lead;
+
+  // 9 digits always read back, and any more than a count which does,
+  //   so the shortest is found by bisection
+  auto rounded = [&](int count) {
+    return uint64_t(magnitude * power(count - 1 - lead) + 0.5);
+  };
+  auto reads_back = [&](uint64_t digits, int count) {
+    return float(decimal_value(digits, lead - count + 1)) == magnitude;
+  };
+  int low = 1, count = 9;
+  while (low < count) {
+    int middle = (low + count) / 2;
+    if (reads_back(rounded(middle), middle))
+      count = middle;
+    else
+      low = middle + 1;
+  }
+  uint64_t digits = rounded(count);
+  // a scale inexact in double may round the last digit the wrong way
+  if (count == 9 && !reads_back(digits, count))
+    digits = uint64_t(std::llround(magnitude * std::pow(10.0L, 8 - lead)));
+  // rounded up to the next power of ten
+  if (digits >= uint64_t(power(count) + 0.5)) {
+    digits /= 10;
+    ++lead;
+  }
+  while (count > 1 && digits % 10 == 0) {
+    digits /= 10;
+    --count;
+  }
+
+  char d[10];
+  write_digits(d, digits);
+  if (lead >= -4 && lead < 9) {
+    // positional, as 0.00125 or 125.5
+    if (lead < 0) {
+      *p++ = '0';
+      *p++ = '.';
+      for (int i = -1; i > lead; --i)
+        *p++ = '0';
+      memcpy(p, d, count);
+      p += count;
+    } else {
+      for (int i = 0; i <= lead; ++i)
+        *p++ = (i < count) ? d[i] : '0';
+      if (count > lead + 1) {
+        *p++ = '.';
+        memcpy(p, d + lead + 1, count - lead - 1);
+        p += count - lead - 1;
+      }
+    }
+  } else {
+    // scientific, as 1.25e-07
+    *p++ = d[0];
+    if (count > 1) {
+      *p++ = '.';
+      memcpy(p, d + 1, count - 1);
+      p += count - 1;
     }
-    samples[i] = s;
+    *p++ = 'e';
+    *p++ = (lead < 0) ? '-' : '+';
+    int e = std::abs(lead);
+    if (e < 10)
+      *p++ = '0';
+    p += write_digits(p, e);
   }
+  size_ += p - text;
 }
 
 void write_wave(const float *in_samples,
@@ -55,17 +228,35 @@ void write_wave(const float *in_samples,
                 unsigned out_sample_count,
                 WaveFormat fmt,
                 WaveDataType type,
-                std::ostream &out) {
+                std::ostream &out,
+                ResampleQuality quality) {
   std::vector<float> out_samples(out_sample_count);
   resample(in_samples, in_sample_count,
-           out_samples.data(), out_sample_count);
+           out_samples.data(), out_sample_count, quality);
+
+  // binary, quantized by the writer of RIFF
+  if (fmt == WaveRiff) {
+    RiffSampleFormat riff =
+      (type == WaveInt16) ? RiffInt16 :
+      (type == WaveInt24) ? RiffInt24 :
+      (type == WaveInt8) ? RiffUInt8 : RiffFloat32;
+    write_riff_wave(out_samples.data(), out_sample_count, 1,
+                    wave_riff_sample_rate, riff, out);
+    return;
+  }
 
   convert_from_float(out_samples.data(), out_sample_count, type);
 
+  TextWriter text(out);
   switch (fmt) {
    case WaveDat:
-    for (int i = 0; i < out_sample_count; ++i)
-      out << out_samples[i] << '\n';
+    for (unsigned i = 0; i < out_sample_count; ++i) {
+      if (type == WaveFloat)
+        text.putFloat(out_samples[i]);
+      else
+        text.putInteger(long(out_samples[i]));
+      text.put('\n');
+    }
     break;
 
    case WaveCpp:
@@ -73,40 +264,159 @@ void write_wave(const float *in_samples,
      const char *ctypename =
        (type == WaveFloat) ? "float" :
        (type == WaveInt16) ? "int16_t" :
-       (type == WaveInt8) ? "int8_t" : nullptr;
+       (type == WaveInt8) ? "int8_t" :
+       (type == WaveInt24) ? "int32_t" : nullptr;
      assert(ctypename);
-     if (fmt == WaveCpp)
-         out << "#include <array>\n" "#include <cstdint>\n\n"
-             "[[gnu::unused]] static constexpr std::array<"
-             << ctypename << ", " << out_sample_count << "> table {\n";
-     else
-         out << "#include <stdint.h>\n\n"
-             "static const "
-             << ctypename << " table [" << out_sample_count << "] = {\n";
-     for (int i = 0; i < out_sample_count; ++i)
-       out << ' ' << out_samples[i] << ',';
-     out << " };\n";
+     if (fmt == WaveCpp) {
+       text.put("#include <array>\n" "#include <cstdint>\n\n"
+                "[[gnu::unused]] static constexpr std::array<");
+       text.put(ctypename);
+       text.put(", ");
+       text.putInteger(out_sample_count);
+       text.put("> table {\n");
+     } else {
+       text.put("#include <stdint.h>\n\n" "static const ");
+       text.put(ctypename);
+       text.put(" table [");
+       text.putInteger(out_sample_count);
+       text.put("] = {\n");
+     }
+     for (unsigned i = 0; i < out_sample_count; ++i) {
+       text.put(' ');
+       if (type == WaveFloat)
+         text.putFloat(out_samples[i]);
+       else
+         text.putInteger(long(out_samples[i]));
+       text.put(',');
+     }
+     text.put(" };\n");
      break;
    }
 
    default:
      throw std::runtime_error("unsupported wave output format");
   }
+  text.flush();
+}
+
+// the whole of a stream, sized at once if the stream can seek
+static bool read_stream_data(std::istream &in, std::string &data) {
+  data.clear();
+  std::istream::pos_type start = in.tellg();
+  if (start != std::istream::pos_type(-1)) {
+    if (in.seekg(0, std::ios::end))
+      data.reserve(size_t(in.tellg() - start) + 1);
+    in.clear();
+    in.seekg(start);
+  }
+
+  size_t count = 0;
+  while (in) {
+    data.resize(std::max<size_t>(data.capacity(), count + 65536));
+    in.read(&data[count], data.size() - count);
+    count += in.gcount();
+  }
+  data.resize(count);
+
+  return !in.bad();
+}
+
+// gives `read` the data of a file, from a mapping of its pages if it can
+template <class Read>
+static bool read_file_data(const std::string &path, Read read) {
+#if defined(DESSINER_HAVE_MMAP)
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return false;
+  BOOST_SCOPE_EXIT_TPL(fd) { close(fd); } BOOST_SCOPE_EXIT_END;
+
+  // the parsers read from the pages of the file, without a copy
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    size_t size = st.st_size;
+    if (size == 0)
+      return read("", 0);
+
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      BOOST_SCOPE_EXIT_TPL(data, size) { munmap(data, size); } BOOST_SCOPE_EXIT_END;
+      madvise(data, size, MADV_SEQUENTIAL);
+      return read(static_cast<const char *>(data), size);
+    }
+  }
+#endif
+
+  // pipes, devices and systems without mmap
+  std::ifstream in(path, std::ios::binary);
+  std::string data;
+  if (!in || !read_stream_data(in, data))
+    return false;
+  return read(data.data(), data.size());
 }
 
 bool read_wave_from_stream(float *out_samples,
                            unsigned out_sample_count,
                            std::istream &in,
                            WaveFormat fmt,
-                           unsigned channel) {
-  std::ostringstream tmp(std::ios::binary);
-  boost::iostreams::copy(in, tmp);
-
-  if (in.bad())
+                           unsigned channel,
+                           ResampleQuality quality,
+                           unsigned frame_length,
+                           unsigned frame) {
+  // one copy of the data
+  std::string data;
+  if (!read_stream_data(in, data))
     return false;
 
   return read_wave_from_string(
-    out_samples, out_sample_count, tmp.str(), fmt, channel);
+    out_samples, out_sample_count, data, fmt, channel, quality,
+    frame_length, frame);
+}
+
+bool read_wave_bank_from_stream(std::vector<float> &out_samples,
+                                unsigned out_frame_length,
+                                std::istream &in,
+                                WaveFormat fmt,
+                                unsigned channel,
+                                ResampleQuality quality,
+                                unsigned frame_length,
+                                unsigned jobs) {
+  std::string data;
+  if (!read_stream_data(in, data))
+    return false;
+
+  return read_wave_bank_from_string(
+    out_samples, out_frame_length, data, fmt, channel, quality,
+    frame_length, jobs);
+}
+
+bool read_wave_from_file(float *out_samples,
+                         unsigned out_sample_count,
+                         const std::string &path,
+                         WaveFormat fmt,
+                         unsigned channel,
+                         ResampleQuality quality,
+                         unsigned frame_length,
+                         unsigned frame) {
+  return read_file_data(path, [&](const char *in, size_t in_size) {
+    return read_wave_from_memory(
+      out_samples, out_sample_count, in, in_size, fmt, channel, quality,
+      frame_length, frame);
+  });
+}
+
+bool read_wave_bank_from_file(std::vector<float> &out_samples,
+                              unsigned out_frame_length,
+                              const std::string &path,
+                              WaveFormat fmt,
+                              unsigned channel,
+                              ResampleQuality quality,
+                              unsigned frame_length,
+                              unsigned jobs) {
+  return read_file_data(path, [&](const char *in, size_t in_size) {
+    return read_wave_bank_from_memory(
+      out_samples, out_frame_length, in, in_size, fmt, channel, quality,
+      frame_length, jobs);
+  });
 }
 
 static WaveDataType detect_data_type(const float *samples,
@@ -114,23 +424,18 @@ static WaveDataType detect_data_type(const float *samples,
   if (sample_count == 0)
     return WaveFloat;
 
-  bool allinteger = true;
-  float min = samples[0];
-  float max = samples[0];
-
-  for (unsigned i = 0; i < sample_count; ++i) {
-    float s = samples[i];
-    if (s < min) min = s;
-    if (s > max) max = s;
-    if (s != int(s)) allinteger = false;
-  }
+  float min, max;
+  bool allinteger;
+  scan_samples(samples, sample_count, min, max, allinteger);
 
   WaveDataType type = WaveFloat;
   if (allinteger) {
     if (min >= INT8_MIN && max <= INT8_MAX)
       type = WaveInt8;
-    else
+    else if (min >= INT16_MIN && max <= INT16_MAX)
       type = WaveInt16;
+    else
+      type = WaveInt24;
   }
 
   static const char *datatypenames[] = WAVE_DATA_TYPE_NAMES;
@@ -139,103 +444,372 @@ static WaveDataType detect_data_type(const float *samples,
   return type;
 }
 
-static bool read_wave_from_dat(float *out_samples,
-                               unsigned out_sample_count,
-                               const std::string &in_,
-                               unsigned channel) {
-  std::vector<float> in_samples;
-  in_samples.reserve(8192);
+// the samples of a frame within those of a channel, false if beyond them
+static bool frame_range(size_t sample_count,
+                        unsigned frame_length,
+                        unsigned frame,
+                        size_t &first,
+                        size_t &count) {
+  first = size_t(frame) * frame_length;
+  count = frame_length ? frame_length : sample_count;
+  return (frame_length != 0 || frame == 0) && first + count <= sample_count;
+}
 
-  std::istringstream in(in_, std::ios::binary);
+// what the readers give of the channel they decode
+//   Either the table `frame` of `frameLength` samples, or with a `bank`,
+//   every table of the channel, one after the other.
+struct WaveOutput {
+  float *samples;
+  unsigned sampleCount;
+  ResampleQuality quality;
+  unsigned frameLength;
+  unsigned frame;
+  std::vector<float> *bank;
+  unsigned jobs;
+};
 
-  std::string line;
-  line.reserve(256);
-  std::vector<float> row;
-  row.reserve(16);
+static bool resample_frames(const float *samples,
+                            size_t sample_count,
+                            const WaveOutput &out) {
+  if (!out.bank) {
+    size_t first, count;
+    if (!frame_range(sample_count, out.frameLength, out.frame, first, count))
+      return false;
+    resample(samples + first, count, out.samples, out.sampleCount, out.quality);
+    return true;
+  }
 
-  do {
-    line.clear();
-    std::getline(in, line);
+  // the whole tables, a rest of fewer samples left out
+  const size_t length = out.frameLength ? out.frameLength : sample_count;
+  const size_t frame_count = length ? sample_count / length : 0;
+  if (frame_count == 0)
+    return false;
 
-    size_t commentpos = line.rfind('#');
-    if (commentpos != line.npos)
-      line.resize(commentpos);
-    boost::trim_if(line, boost::is_any_of("\t "));
+  out.bank->resize(frame_count * out.sampleCount);
+  std::vector<const float *> in_tables(frame_count);
+  std::vector<float *> out_tables(frame_count);
+  for (size_t i = 0; i < frame_count; ++i) {
+    in_tables[i] = samples + i * length;
+    out_tables[i] = out.bank->data() + i * out.sampleCount;
+  }
 
-    if (!line.empty()) {
-      float sample;
-      row.clear();
-      for (std::istringstream linestream(line, std::ios::binary);
-           linestream >> sample;)
-        row.push_back(sample);
+  resample_batch(in_tables.data(), length, out_tables.data(), out.sampleCount,
+                 frame_count, out.quality, out.jobs);
+  return true;
+}
+
+static bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static bool is_identifier_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || is_digit(c);
+}
+
+// an unsigned C literal at `p`, decimal or hexadecimal, integer or floating
+//   Digits are read once, independently of the locale. Leading zeros are
+//   decimal, not octal, as before. Suffixes of type are skipped.
+static bool parse_c_number(const char *&p, const char *end, double &value) {
+  const char *q = p;
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  bool digits = false;
+
+  if (end - q > 2 && q[0] == '0' && (q[1] == 'x' || q[1] == 'X') &&
+      (hex_digit(q[2]) >= 0 || (q[2] == '.' && end - q > 3 && hex_digit(q[3]) >= 0))) {
+    // hexadecimal, with an exponent of 2; 60 bits are enough of a mantissa
+    q += 2;
+    for (int d; q < end && (d = hex_digit(*q)) >= 0; ++q, digits = true) {
+      if (mantissa >> 60) exponent += 4;
+      else mantissa = mantissa * 16 + d;
+    }
+    if (q < end && *q == '.') {
+      for (int d; ++q < end && (d = hex_digit(*q)) >= 0; digits = true) {
+        if (!(mantissa >> 60)) {
+          mantissa = mantissa * 16 + d;
+          exponent -= 4;
+        }
+      }
+    }
+    if (q < end && (*q == 'p' || *q == 'P')) {
+      const char *e = q + 1;
+      bool negative = e < end && *e == '-';
+      if (e < end && (*e == '-' || *e == '+'))
+        ++e;
+      if (e == end || !is_digit(*e))
+        return false;
+      int power = 0;
+      for (; e < end && is_digit(*e); ++e)
+        power = std::min(power * 10 + (*e - '0'), 100000);
+      exponent += negative ? -power : power;
+      q = e;
+    }
+    value = std::ldexp(double(mantissa), exponent);
+  } else {
+    // decimal; beyond 19 digits, only their count matters to a float
+    const uint64_t limit = 1000000000000000000ull;
+    for (; q < end && is_digit(*q); ++q, digits = true) {
+      if (mantissa >= limit) ++exponent;
+      else mantissa = mantissa * 10 + (*q - '0');
+    }
+    if (q < end && *q == '.') {
+      for (; ++q < end && is_digit(*q); digits = true) {
+        if (mantissa < limit) {
+          mantissa = mantissa * 10 + (*q - '0');
+          --exponent;
+        }
+      }
+    }
+    if (!digits)
+      return false;
+    if (q < end && (*q == 'e' || *q == 'E')) {
+      const char *e = q + 1;
+      bool negative = e < end && *e == '-';
+      if (e < end && (*e == '-' || *e == '+'))
+        ++e;
+      if (e == end || !is_digit(*e))
+        return false;
+      int power = 0;
+      for (; e < end && is_digit(*e); ++e)
+        power = std::min(power * 10 + (*e - '0'), 100000);
+      exponent += negative ? -power : power;
+      q = e;
+    }
+
+    value = decimal_value(mantissa, exponent);
+  }
+
+  if (!digits)
+    return false;
+
+  // u, l, f and their combinations
+  while (q < end && (*q == 'u' || *q == 'U' || *q == 'l' || *q == 'L' ||
+                     *q == 'f' || *q == 'F'))
+    ++q;
+  if (q < end && (is_identifier_char(*q) || *q == '.'))
+    return false;
+
+  p = q;
+  return true;
+}
+
+static bool read_wave_from_dat(const char *in,
+                               size_t in_size,
+                               unsigned channel,
+                               const WaveOutput &out) {
+  const char *p = in;
+  const char *const end = p + in_size;
+
+  std::vector<float> in_samples;
+  in_samples.reserve(std::count(p, end, '\n') + 1);
+
+  auto is_blank = [](char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; };
+
+  // a line at a time, reading the numbers of one column only
+  //   Every line has a sample, the lines empty or of comment repeating the
+  //   last row, and the text after the last newline counts as a line.
+  float sample = 0;
+  for (;;) {
+    const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+    if (!eol)
+      eol = end;
+
+    while (p < eol && (*p == ' ' || *p == '\t'))
+      ++p;
+
+    // the comment runs from the last '#'
+    bool empty = p == eol ||
+      (*p == '#' && !memchr(p + 1, '#', eol - (p + 1)));
+
+    if (!empty) {
+      while (p < eol && is_blank(*p))
+        ++p;
+      for (unsigned c = 0; c < channel && p < eol && *p != '#'; ++c) {
+        while (p < eol && !is_blank(*p) && *p != '#')
+          ++p;
+        while (p < eol && is_blank(*p))
+          ++p;
+      }
+
+      // a missing column is 0
+      double value;
+      bool negative = p < eol && *p == '-';
+      if (p < eol && (*p == '-' || *p == '+'))
+        ++p;
+      if (p == eol || *p == '#' || !parse_c_number(p, eol, value))
+        value = 0;
+      sample = float(negative ? -value : value);
     }
 
-    in_samples.push_back(
-      (channel < row.size()) ? row[channel] : 0.0f);
-  } while (in);
+    in_samples.push_back(sample);
+
+    if (eol == end)
+      break;
+    p = eol + 1;
+  }
 
+  ///
   WaveDataType type = detect_data_type(in_samples.data(), in_samples.size());
   convert_to_float(in_samples.data(), in_samples.size(), type);
 
-  resample(in_samples.data(), in_samples.size(),
-           out_samples, out_sample_count);
-  return true;
+  return resample_frames(in_samples.data(), in_samples.size(), out);
 }
 
-static bool read_wave_from_cpp(float *out_samples,
-                               unsigned out_sample_count,
-                               const std::string &in,
-                               unsigned channel) {
+static bool read_wave_from_cpp(const char *in,
+                               size_t in_size,
+                               unsigned channel,
+                               const WaveOutput &out) {
   std::vector<float> in_samples;
   in_samples.reserve(8192);
 
   ///
 
-  size_t index = 0;
+  // a single pass over the text, each character looked at once or twice
+  const char *p = in;
+  const char *const end = p + in_size;
 
-  auto is_whitespace = [&](char c) {
-    return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
-  auto nth_char = [&](size_t n) {
-    return (index + n >= in.size()) ? '\0' : in[index + n]; };
-  auto skip = [&](size_t n) {
-    index = std::min(in.size(), index + n); };
+  auto skip_comment = [&]() -> bool {
+    if (end - p < 2 || p[0] != '/')
+      return false;
+    if (p[1] == '/') {
+      const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+      p = eol ? eol + 1 : end;
+      return true;
+    }
+    if (p[1] == '*') {
+      const char *q = p + 2;
+      while (q + 1 < end && !(q[0] == '*' && q[1] == '/'))
+        ++q;
+      p = (q + 1 < end) ? q + 2 : end;
+      return true;
+    }
+    return false;
+  };
   auto consume_whitespace = [&]() {
-    while (is_whitespace(nth_char(0))) skip(1); };
-  auto end_of_input = [&]() {
-    return index >= in.size(); };
+    for (; p < end; ++p) {
+      char c = *p;
+      if (c == '/' && skip_comment())
+        --p;
+      else if (c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != '\v' && c != '\f')
+        break;
+    }
+  };
+  auto skip_to_brace = [&]() -> bool {
+    while (p < end) {
+      char c = *p;
+      if (c == '{')
+        return true;
+      if (c == '/' && skip_comment())
+        continue;
+      if (c == '"' || c == '\'') {
+        // a literal, which may hold braces
+        for (++p; p < end && *p != c && *p != '\n'; ++p) {
+          if (*p == '\\' && p + 1 < end)
+            ++p;
+        }
+      }
+      if (p < end)
+        ++p;
+    }
+    return false;
+  };
 
   ///
+  // a number, with signs, casts and parentheses before it
+  auto read_sample = [&](float &sample) -> bool {
+    bool negative = false;
+    unsigned parens = 0;
+    for (;;) {
+      consume_whitespace();
+      if (p == end)
+        return false;
+      char c = *p;
+      if (c == '-' || c == '+') {
+        negative ^= (c == '-');
+        ++p;
+      } else if (c == '(') {
+        // a cast as (type), else a parenthesis
+        const char *q = p + 1;
+        while (q < end && (*q == ' ' || *q == '\t'))
+          ++q;
+        if (q < end && is_identifier_char(*q) && !is_digit(*q)) {
+          const char *close = static_cast<const char *>(memchr(q, ')', end - q));
+          if (!close)
+            return false;
+          p = close + 1;
+        } else {
+          ++parens;
+          ++p;
+        }
+      } else if (is_identifier_char(c) && !is_digit(c)) {
+        // a cast as type(x) or static_cast<type>(x)
+        while (p < end && (is_identifier_char(*p) || *p == ':'))
+          ++p;
+        consume_whitespace();
+        if (p < end && *p == '<') {
+          const char *close = static_cast<const char *>(memchr(p, '>', end - p));
+          if (!close)
+            return false;
+          p = close + 1;
+          consume_whitespace();
+        }
+        if (p == end || *p != '(')
+          return false;
+        ++parens;
+        ++p;
+      } else {
+        break;
+      }
+    }
+
+    double value;
+    if (!parse_c_number(p, end, value))
+      return false;
+    for (; parens > 0; --parens) {
+      consume_whitespace();
+      if (p == end || *p != ')')
+        return false;
+      ++p;
+    }
+    sample = float(negative ? -value : value);
+    return true;
+  };
+
   auto read_sample_array = [&]() -> bool {
-    if (nth_char(0) != '{')
+    if (p == end || *p != '{')
       return false;
-    skip(1);
+    ++p;
     in_samples.clear();
-    while (nth_char(0) != '}') {
+    for (;;) {
       consume_whitespace();
-      float num {};
-      unsigned nscanf {};
-      /* TODO more C++ literal forms than scanf can handle */
-      if (sscanf(in.c_str() + index, "%f%n", &num, &nscanf) != 1)
+      if (p < end && *p == '}') {
+        ++p;
+        return true;
+      }
+      float sample;
+      if (!read_sample(sample))
         return false;
-      index += nscanf;
-      in_samples.push_back(num);
+      in_samples.push_back(sample);
       consume_whitespace();
-      if (nth_char(0) == '}') {
-      } else if (nth_char(0) == ',') {
-        skip(1);
-        consume_whitespace();
-      } else
+      if (p < end && *p == ',')
+        ++p;
+      else if (p == end || *p != '}')
         return false;
     }
-    return true;
   };
 
   ///
   bool have_samples = false;
   for (unsigned c = 0; !have_samples && c <= channel;) {
-    while (!end_of_input() && nth_char(0) != '{')
-      skip(1);
-    if (end_of_input())
+    if (!skip_to_brace())
       break;
     if (!read_sample_array())
       continue;
@@ -250,25 +824,75 @@ static bool read_wave_from_cpp(float *out_samples,
   WaveDataType type = detect_data_type(in_samples.data(), in_samples.size());
   convert_to_float(in_samples.data(), in_samples.size(), type);
 
-  resample(in_samples.data(), in_samples.size(),
-           out_samples, out_sample_count);
-  return true;
+  return resample_frames(in_samples.data(), in_samples.size(), out);
 };
 
+static bool read_wave_from_riff(const char *in,
+                                size_t in_size,
+                                unsigned channel,
+                                const WaveOutput &out) {
+  RiffWaveView view;
+  if (!read_riff_wave(in, in_size, view) || channel >= view.channel_count)
+    return false;
+
+  // the samples of the frame only, converted from their place in the file
+  //   A bank needs them all.
+  size_t first = 0, count = view.frame_count;
+  if (!out.bank &&
+      !frame_range(view.frame_count, out.frameLength, out.frame, first, count))
+    return false;
+
+  std::vector<float> in_samples(count);
+  read_riff_samples(view, channel, first, count, in_samples.data());
+
+  if (out.bank)
+    return resample_frames(in_samples.data(), count, out);
+
+  resample(in_samples.data(), count, out.samples, out.sampleCount, out.quality);
+  return true;
+}
+
 bool read_wave_from_string(float *out_samples,
                            unsigned out_sample_count,
                            const std::string &in,
                            WaveFormat fmt,
-                           unsigned channel) {
+                           unsigned channel,
+                           ResampleQuality quality,
+                           unsigned frame_length,
+                           unsigned frame) {
+  return read_wave_from_memory(
+    out_samples, out_sample_count, in.data(), in.size(), fmt, channel, quality,
+    frame_length, frame);
+}
+
+bool read_wave_bank_from_string(std::vector<float> &out_samples,
+                                unsigned out_frame_length,
+                                const std::string &in,
+                                WaveFormat fmt,
+                                unsigned channel,
+                                ResampleQuality quality,
+                                unsigned frame_length,
+                                unsigned jobs) {
+  return read_wave_bank_from_memory(
+    out_samples, out_frame_length, in.data(), in.size(), fmt, channel, quality,
+    frame_length, jobs);
+}
+
+static bool read_wave_output(const char *in,
+                             size_t in_size,
+                             WaveFormat fmt,
+                             unsigned channel,
+                             const WaveOutput &out) {
   switch (fmt) {
     case WaveDat:
-      return read_wave_from_dat(
-        out_samples, out_sample_count, in, channel);
+      return read_wave_from_dat(in, in_size, channel, out);
 
     case WaveCpp:
     case WaveC:
-      return read_wave_from_cpp(
-        out_samples, out_sample_count, in, channel);
+      return read_wave_from_cpp(in, in_size, channel, out);
+
+    case WaveRiff:
+      return read_wave_from_riff(in, in_size, channel, out);
 
    default:
      throw std::runtime_error("unsupported wave input format");
@@ -276,3 +900,31 @@ bool read_wave_from_string(float *out_samples,
 
   return false;
 }
+
+bool read_wave_from_memory(float *out_samples,
+                           unsigned out_sample_count,
+                           const char *in,
+                           size_t in_size,
+                           WaveFormat fmt,
+                           unsigned channel,
+                           ResampleQuality quality,
+                           unsigned frame_length,
+                           unsigned frame) {
+  const WaveOutput out {
+    out_samples, out_sample_count, quality, frame_length, frame, nullptr, 0};
+  return read_wave_output(in, in_size, fmt, channel, out);
+}
+
+bool read_wave_bank_from_memory(std::vector<float> &out_samples,
+                                unsigned out_frame_length,
+                                const char *in,
+                                size_t in_size,
+                                WaveFormat fmt,
+                                unsigned channel,
+                                ResampleQuality quality,
+                                unsigned frame_length,
+                                unsigned jobs) {
+  const WaveOutput out {
+    nullptr, out_frame_length, quality, frame_length, 0, &out_samples, jobs};
+  return read_wave_output(in, in_size, fmt, channel, out);
+}
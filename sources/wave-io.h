@@ -1,49 +1,124 @@
 #pragma once
+#include "math-dsp.h"
 #include <vector>
+#include <string>
 #include <iosfwd>
+#include <cstddef>
 
 enum WaveFormat {
   WaveDat,
   WaveCpp,
   WaveC,
+  WaveRiff,
 };
 
 #define WAVE_FORMAT_NAME_FILTERS                \
   {"Data points (*.dat)",                       \
    "C++ source (*.h)",                          \
-   "C source (*.h)"}
+   "C source (*.h)",                            \
+   "RIFF WAVE (*.wav)"}
 #define WAVE_FORMAT_SUFFIXES                    \
-  {".dat", ".h"}
+  {".dat", ".h", ".h", ".wav"}
 
 enum WaveDataType {
   WaveFloat,
   WaveInt16,
   WaveInt8,
+  WaveInt24,
 };
 
 #define WAVE_DATA_TYPE_NAMES                    \
-  {"32-bit float", "16-bit signed integer", "8-bit signed integer"}
+  {"32-bit float", "16-bit signed integer", "8-bit signed integer", \
+   "24-bit signed integer"}
+
+// the sample rate of RIFF WAVE tables, which have no rate of their own
+static constexpr unsigned wave_riff_sample_rate = 44100;
 
 void write_wave(const float *in_samples,
                 unsigned in_sample_count,
                 unsigned out_sample_count,
                 WaveFormat fmt,
                 WaveDataType type,
-                std::ostream &out);
+                std::ostream &out,
+                ResampleQuality quality = ResamplePeriodic);
 
+// the readers give the table of one channel
+//   With a `frame_length`, the channel is a bank of tables of this many
+//   samples, and `frame` selects one; without, it is a single table.
 bool read_wave_from_stream(float *out_samples,
                            unsigned out_sample_count,
                            std::istream &in,
                            WaveFormat fmt,
-                           unsigned channel);
+                           unsigned channel,
+                           ResampleQuality quality = ResamplePeriodic,
+                           unsigned frame_length = 0,
+                           unsigned frame = 0);
 
 bool read_wave_from_string(float *out_samples,
                            unsigned out_sample_count,
                            const std::string &in,
                            WaveFormat fmt,
-                           unsigned channel);
+                           unsigned channel,
+                           ResampleQuality quality = ResamplePeriodic,
+                           unsigned frame_length = 0,
+                           unsigned frame = 0);
+
+bool read_wave_from_memory(float *out_samples,
+                           unsigned out_sample_count,
+                           const char *in,
+                           size_t in_size,
+                           WaveFormat fmt,
+                           unsigned channel,
+                           ResampleQuality quality = ResamplePeriodic,
+                           unsigned frame_length = 0,
+                           unsigned frame = 0);
+
+// reads the file from a mapping of its pages, else as a stream
+bool read_wave_from_file(float *out_samples,
+                         unsigned out_sample_count,
+                         const std::string &path,
+                         WaveFormat fmt,
+                         unsigned channel,
+                         ResampleQuality quality = ResamplePeriodic,
+                         unsigned frame_length = 0,
+                         unsigned frame = 0);
+
+// the readers of a whole bank give all its tables, one after the other,
+//   each resampled to `out_frame_length` over `jobs` threads, 0 for one
+//   per processor. A rest shorter than `frame_length` is left out.
+bool read_wave_bank_from_stream(std::vector<float> &out_samples,
+                                unsigned out_frame_length,
+                                std::istream &in,
+                                WaveFormat fmt,
+                                unsigned channel,
+                                ResampleQuality quality = ResamplePeriodic,
+                                unsigned frame_length = 0,
+                                unsigned jobs = 0);
+
+bool read_wave_bank_from_string(std::vector<float> &out_samples,
+                                unsigned out_frame_length,
+                                const std::string &in,
+                                WaveFormat fmt,
+                                unsigned channel,
+                                ResampleQuality quality = ResamplePeriodic,
+                                unsigned frame_length = 0,
+                                unsigned jobs = 0);
+
+bool read_wave_bank_from_memory(std::vector<float> &out_samples,
+                                unsigned out_frame_length,
+                                const char *in,
+                                size_t in_size,
+                                WaveFormat fmt,
+                                unsigned channel,
+                                ResampleQuality quality = ResamplePeriodic,
+                                unsigned frame_length = 0,
+                                unsigned jobs = 0);
 
-void resample(const float *in_samples,
-              unsigned in_sample_count,
-              float *out_samples,
-              unsigned out_sample_count);
+bool read_wave_bank_from_file(std::vector<float> &out_samples,
+                              unsigned out_frame_length,
+                              const std::string &path,
+                              WaveFormat fmt,
+                              unsigned channel,
+                              ResampleQuality quality = ResamplePeriodic,
+                              unsigned frame_length = 0,
+                              unsigned jobs = 0);
@@ -0,0 +1,73 @@
+#define WAVE_RENDER_KERNELS_IMPL
+#include "wave-render-kernels.h"
+#include <immintrin.h>
+
+namespace {
+
+struct SimdAVX2 {
+  typedef __m256 F;
+  typedef __m256i I;
+  static const unsigned width = 8;
+
+  static F set1(float x) { return _mm256_set1_ps(x); }
+  static F rampf(float x, float step) {
+    F k = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+    return _mm256_fmadd_ps(_mm256_set1_ps(step), k, _mm256_set1_ps(x));
+  }
+  static I set1i(uint32_t x) { return _mm256_set1_epi32(int(x)); }
+  static I ramp(uint32_t phase, uint32_t inc) {
+    I k = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    return _mm256_add_epi32(_mm256_set1_epi32(int(phase)),
+                            _mm256_mullo_epi32(_mm256_set1_epi32(int(inc)), k));
+  }
+  static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+  static I index(I phase, unsigned shift) {
+    return _mm256_srl_epi32(phase, _mm_cvtsi32_si128(int(shift)));
+  }
+  static F frac(I phase, uint32_t mask, float scale) {
+    I bits = _mm256_and_si256(phase, _mm256_set1_epi32(int(mask)));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(bits), _mm256_set1_ps(scale));
+  }
+  static F gather(const float *base, I index, int offset) {
+    return _mm256_i32gather_ps(base + offset, index, 4);
+  }
+  static F add(F a, F b) { return _mm256_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+  static F madd(F a, F b, F c) { return _mm256_fmadd_ps(a, b, c); }
+  static void store(float *p, F x) { _mm256_storeu_ps(p, x); }
+
+  static float hsum(F x) {
+    __m128 v = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+    __m128 shuf = _mm_movehdup_ps(v);
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+  }
+
+  template <bool Crossfade>
+  static F taps8(const float *x, const float *y, float mix) {
+    F s = _mm256_loadu_ps(x);
+    if (Crossfade)
+      s = madd(_mm256_set1_ps(mix), sub(_mm256_loadu_ps(y), s), s);
+    return s;
+  }
+
+  template <bool Crossfade, bool Morph>
+  static float dot8(const float *coef, float rowmu,
+                    const float *x, const float *y, ptrdiff_t fs,
+                    float mix, float morph) {
+    F c = _mm256_loadu_ps(coef);
+    c = madd(_mm256_set1_ps(rowmu), sub(_mm256_loadu_ps(coef + 8), c), c);
+    F s = taps8<Crossfade>(x, y, mix);
+    if (Morph)
+      s = madd(_mm256_set1_ps(morph), sub(taps8<Crossfade>(x + fs, y + fs, mix), s), s);
+    return hsum(mul(c, s));
+  }
+};
+
+}  // namespace
+
+RenderKernels render_kernels_avx2() {
+  return make_render_kernels<SimdAVX2>();
+}
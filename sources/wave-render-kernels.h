@@ -0,0 +1,232 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// private to the wave renderer: kernels generic over a SIMD type
+//   Each instruction set has its own translation unit, compiled with its
+//   own flags, which instantiates these templates in an anonymous namespace.
+
+struct RenderArgs {
+  const float *table1;
+  const float *table2;
+  float mix;
+  ptrdiff_t frameStride;
+  float morph;
+  float morphStep;
+  unsigned log2size;
+  uint32_t phase;
+  uint32_t increment;
+  float *out;
+  unsigned count;
+  const float *sinc;
+};
+
+typedef uint32_t (*RenderKernel)(const RenderArgs &args);
+
+// by quality, then without and with morph, then without and with crossfade
+struct RenderKernels {
+  RenderKernel linear[2][2];
+  RenderKernel hermite[2][2];
+  RenderKernel sinc[2][2];
+};
+
+// polyphase windowed sinc, rows of 8 taps for the offsets -3 to +4
+//   there are `sinc_phases + 1` rows, for interpolating between them
+static const unsigned sinc_taps = 8;
+static const unsigned sinc_phase_bits = 9;
+static const unsigned sinc_phases = 1u << sinc_phase_bits;
+
+RenderKernels render_kernels_generic();
+#if defined(DESSINER_X86_SIMD)
+RenderKernels render_kernels_sse2();
+RenderKernels render_kernels_avx2();
+#endif
+
+#if defined(WAVE_RENDER_KERNELS_IMPL)
+namespace {
+
+struct SimdGeneric {
+  typedef float F;
+  typedef uint32_t I;
+  static const unsigned width = 1;
+
+  static F set1(float x) { return x; }
+  static F rampf(float x, float) { return x; }
+  static I set1i(uint32_t x) { return x; }
+  static I ramp(uint32_t phase, uint32_t) { return phase; }
+  static I addi(I a, I b) { return a + b; }
+  static I index(I phase, unsigned shift) { return phase >> shift; }
+  static F frac(I phase, uint32_t mask, float scale) { return (phase & mask) * scale; }
+  static F gather(const float *base, I index, int offset) { return base[int(index) + offset]; }
+  static F add(F a, F b) { return a + b; }
+  static F sub(F a, F b) { return a - b; }
+  static F mul(F a, F b) { return a * b; }
+  static F madd(F a, F b, F c) { return a * b + c; }
+  static void store(float *p, F x) { *p = x; }
+
+  template <bool Crossfade, bool Morph>
+  static float dot8(const float *coef, float rowmu,
+                    const float *x, const float *y, ptrdiff_t fs,
+                    float mix, float morph) {
+    float sum = 0;
+    for (unsigned k = 0; k < 8; ++k) {
+      float c = coef[k] + rowmu * (coef[k + 8] - coef[k]);
+      float s = x[k];
+      if (Crossfade)
+        s += mix * (y[k] - s);
+      if (Morph) {
+        float t = x[k + fs];
+        if (Crossfade)
+          t += mix * (y[k + fs] - t);
+        s += morph * (t - s);
+      }
+      sum += c * s;
+    }
+    return sum;
+  }
+};
+
+template <class V>
+struct PhaseFormat {
+  explicit PhaseFormat(unsigned log2size)
+    : shift(32 - log2size),
+      mask((uint32_t(1) << shift) - 1),
+      scale(1.0f / float(uint64_t(1) << shift)) {}
+  unsigned shift;
+  uint32_t mask;
+  float scale;
+};
+
+// a table value, crossfaded between levels and morphed between frames
+//   the interpolations are linear, so tables are blended before them
+template <class V, bool Crossfade, bool Morph>
+typename V::F fetch(const RenderArgs &a, typename V::I idx, int offset,
+                    typename V::F mix, typename V::F morph) {
+  typename V::F x = V::gather(a.table1, idx, offset);
+  if (Crossfade)
+    x = V::madd(mix, V::sub(V::gather(a.table2, idx, offset), x), x);
+  if (Morph) {
+    typename V::F y = V::gather(a.table1 + a.frameStride, idx, offset);
+    if (Crossfade)
+      y = V::madd(mix, V::sub(V::gather(a.table2 + a.frameStride, idx, offset), y), y);
+    x = V::madd(morph, V::sub(y, x), x);
+  }
+  return x;
+}
+
+// the samples after `done`, left over by a vector loop
+template <RenderKernel Kernel>
+uint32_t render_rest(const RenderArgs &a, unsigned done) {
+  RenderArgs rest = a;
+  rest.phase += done * a.increment;
+  rest.morph += done * a.morphStep;
+  rest.out += done;
+  rest.count -= done;
+  return (rest.count > 0) ? Kernel(rest) : rest.phase;
+}
+
+template <class V, bool Crossfade, bool Morph>
+uint32_t render_linear(const RenderArgs &a) {
+  typedef typename V::F F;
+  typedef typename V::I I;
+  const PhaseFormat<V> pf(a.log2size);
+  const F mix = V::set1(a.mix);
+  const F morphstep = V::set1(a.morphStep * V::width);
+  const I step = V::set1i(a.increment * V::width);
+  I phase = V::ramp(a.phase, a.increment);
+  F morph = V::rampf(a.morph, a.morphStep);
+
+  unsigned i = 0;
+  for (; i + V::width <= a.count; i += V::width) {
+    I idx = V::index(phase, pf.shift);
+    F mu = V::frac(phase, pf.mask, pf.scale);
+    F x0 = fetch<V, Crossfade, Morph>(a, idx, 0, mix, morph);
+    F x1 = fetch<V, Crossfade, Morph>(a, idx, 1, mix, morph);
+    V::store(a.out + i, V::madd(mu, V::sub(x1, x0), x0));
+    phase = V::addi(phase, step);
+    morph = V::add(morph, morphstep);
+  }
+
+  return render_rest<&render_linear<SimdGeneric, Crossfade, Morph>>(a, i);
+}
+
+template <class V, bool Crossfade, bool Morph>
+uint32_t render_hermite(const RenderArgs &a) {
+  typedef typename V::F F;
+  typedef typename V::I I;
+  const PhaseFormat<V> pf(a.log2size);
+  const F mix = V::set1(a.mix);
+  const F morphstep = V::set1(a.morphStep * V::width);
+  const F half = V::set1(0.5f);
+  const F onehalf = V::set1(1.5f);
+  const F two = V::set1(2.0f);
+  const F twohalf = V::set1(2.5f);
+  const I step = V::set1i(a.increment * V::width);
+  I phase = V::ramp(a.phase, a.increment);
+  F morph = V::rampf(a.morph, a.morphStep);
+
+  unsigned i = 0;
+  for (; i + V::width <= a.count; i += V::width) {
+    I idx = V::index(phase, pf.shift);
+    F mu = V::frac(phase, pf.mask, pf.scale);
+    F xm1 = fetch<V, Crossfade, Morph>(a, idx, -1, mix, morph);
+    F x0 = fetch<V, Crossfade, Morph>(a, idx, 0, mix, morph);
+    F x1 = fetch<V, Crossfade, Morph>(a, idx, 1, mix, morph);
+    F x2 = fetch<V, Crossfade, Morph>(a, idx, 2, mix, morph);
+    // 4-point, 3rd-order Hermite (Catmull-Rom)
+    F c1 = V::mul(half, V::sub(x1, xm1));
+    F c2 = V::sub(V::madd(two, x1, xm1), V::madd(twohalf, x0, V::mul(half, x2)));
+    F c3 = V::madd(half, V::sub(x2, xm1), V::mul(onehalf, V::sub(x0, x1)));
+    F s = V::madd(V::madd(V::madd(c3, mu, c2), mu, c1), mu, x0);
+    V::store(a.out + i, s);
+    phase = V::addi(phase, step);
+    morph = V::add(morph, morphstep);
+  }
+
+  return render_rest<&render_hermite<SimdGeneric, Crossfade, Morph>>(a, i);
+}
+
+template <class V, bool Crossfade, bool Morph>
+uint32_t render_sinc(const RenderArgs &a) {
+  // the taps of one sample are a vector, rather than one tap of many samples
+  //   the row is the top bits of the fraction, as a float of all of them
+  //   may round up to the row past the last for small tables
+  const PhaseFormat<V> pf(a.log2size);
+  const unsigned rowshift = pf.shift - sinc_phase_bits;
+  const uint32_t rowmask = (uint32_t(1) << rowshift) - 1;
+  const float rowscale = 1.0f / float(uint32_t(1) << rowshift);
+
+  uint32_t p = a.phase;
+  for (unsigned i = 0; i < a.count; ++i, p += a.increment) {
+    uint32_t idx = p >> pf.shift;
+    uint32_t frac = p & pf.mask;
+    unsigned row = frac >> rowshift;
+    float rowmu = (frac & rowmask) * rowscale;
+    const float *coef = a.sinc + row * sinc_taps;
+    a.out[i] = V::template dot8<Crossfade, Morph>(
+      coef, rowmu, a.table1 + idx - 3, a.table2 + idx - 3, a.frameStride,
+      a.mix, a.morph + i * a.morphStep);
+  }
+  return p;
+}
+
+template <class V>
+RenderKernels make_render_kernels() {
+  RenderKernels k;
+  k.linear[0][0] = &render_linear<V, false, false>;
+  k.linear[0][1] = &render_linear<V, true, false>;
+  k.linear[1][0] = &render_linear<V, false, true>;
+  k.linear[1][1] = &render_linear<V, true, true>;
+  k.hermite[0][0] = &render_hermite<V, false, false>;
+  k.hermite[0][1] = &render_hermite<V, true, false>;
+  k.hermite[1][0] = &render_hermite<V, false, true>;
+  k.hermite[1][1] = &render_hermite<V, true, true>;
+  k.sinc[0][0] = &render_sinc<V, false, false>;
+  k.sinc[0][1] = &render_sinc<V, true, false>;
+  k.sinc[1][0] = &render_sinc<V, false, true>;
+  k.sinc[1][1] = &render_sinc<V, true, true>;
+  return k;
+}
+
+}  // namespace
+#endif
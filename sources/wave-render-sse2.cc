@@ -0,0 +1,85 @@
+#define WAVE_RENDER_KERNELS_IMPL
+#include "wave-render-kernels.h"
+#include <emmintrin.h>
+
+namespace {
+
+struct SimdSSE2 {
+  typedef __m128 F;
+  typedef __m128i I;
+  static const unsigned width = 4;
+
+  static F set1(float x) { return _mm_set1_ps(x); }
+  static F rampf(float x, float step) {
+    return _mm_setr_ps(x, x + step, x + 2 * step, x + 3 * step);
+  }
+  static I set1i(uint32_t x) { return _mm_set1_epi32(int(x)); }
+  static I ramp(uint32_t phase, uint32_t inc) {
+    return _mm_setr_epi32(int(phase), int(phase + inc),
+                          int(phase + 2 * inc), int(phase + 3 * inc));
+  }
+  static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+  static I index(I phase, unsigned shift) {
+    return _mm_srl_epi32(phase, _mm_cvtsi32_si128(int(shift)));
+  }
+  static F frac(I phase, uint32_t mask, float scale) {
+    I bits = _mm_and_si128(phase, _mm_set1_epi32(int(mask)));
+    return _mm_mul_ps(_mm_cvtepi32_ps(bits), _mm_set1_ps(scale));
+  }
+  static F gather(const float *base, I index, int offset) {
+    alignas(16) int32_t k[4];
+    _mm_store_si128((__m128i *)k, index);
+    base += offset;
+    return _mm_setr_ps(base[k[0]], base[k[1]], base[k[2]], base[k[3]]);
+  }
+  static F add(F a, F b) { return _mm_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+  static F madd(F a, F b, F c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static void store(float *p, F x) { _mm_storeu_ps(p, x); }
+
+  static float hsum(F x) {
+    F shuf = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+    F sums = _mm_add_ps(x, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+  }
+
+  template <bool Crossfade>
+  static void taps8(const float *x, const float *y, float mix, F &x0, F &x1) {
+    x0 = _mm_loadu_ps(x);
+    x1 = _mm_loadu_ps(x + 4);
+    if (Crossfade) {
+      F m = _mm_set1_ps(mix);
+      x0 = madd(m, sub(_mm_loadu_ps(y), x0), x0);
+      x1 = madd(m, sub(_mm_loadu_ps(y + 4), x1), x1);
+    }
+  }
+
+  template <bool Crossfade, bool Morph>
+  static float dot8(const float *coef, float rowmu,
+                    const float *x, const float *y, ptrdiff_t fs,
+                    float mix, float morph) {
+    F mu = _mm_set1_ps(rowmu);
+    F c0 = _mm_loadu_ps(coef);
+    F c1 = _mm_loadu_ps(coef + 4);
+    c0 = madd(mu, sub(_mm_loadu_ps(coef + 8), c0), c0);
+    c1 = madd(mu, sub(_mm_loadu_ps(coef + 12), c1), c1);
+    F x0, x1;
+    taps8<Crossfade>(x, y, mix, x0, x1);
+    if (Morph) {
+      F t0, t1;
+      taps8<Crossfade>(x + fs, y + fs, mix, t0, t1);
+      F m = _mm_set1_ps(morph);
+      x0 = madd(m, sub(t0, x0), x0);
+      x1 = madd(m, sub(t1, x1), x1);
+    }
+    return hsum(madd(c1, x1, mul(c0, x0)));
+  }
+};
+
+}  // namespace
+
+RenderKernels render_kernels_sse2() {
+  return make_render_kernels<SimdSSE2>();
+}
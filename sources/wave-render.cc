@@ -0,0 +1,114 @@
+#define WAVE_RENDER_KERNELS_IMPL
+#include "wave-render.h"
+#include "wave-render-kernels.h"
+#include "cpu-dispatch.h"
+#include <vector>
+#include <cmath>
+
+RenderKernels render_kernels_generic() {
+  return make_render_kernels<SimdGeneric>();
+}
+
+static std::vector<float> make_sinc_table() {
+  std::vector<float> table((sinc_phases + 1) * sinc_taps);
+
+  for (unsigned row = 0; row <= sinc_phases; ++row) {
+    double phase = double(row) / sinc_phases;
+    float *coef = &table[row * sinc_taps];
+
+    double sum = 0;
+    for (unsigned k = 0; k < sinc_taps; ++k) {
+      // distance in (-4, +4] of the tap from the interpolated point
+      double d = (int(k) - 3) - phase;
+      double sinc = (d == 0) ? 1.0 : std::sin(M_PI * d) / (M_PI * d);
+      double w = 0.42 + 0.5 * std::cos(M_PI * d / 4) + 0.08 * std::cos(M_PI * d / 2);
+      coef[k] = sinc * w;
+      sum += coef[k];
+    }
+
+    // unity gain at DC
+    for (unsigned k = 0; k < sinc_taps; ++k)
+      coef[k] /= sum;
+  }
+
+  return table;
+}
+
+static RenderKernels select_render_kernels() {
+  switch (cpu_path()) {
+#if defined(DESSINER_X86_SIMD)
+    case CpuAVX2:
+      return render_kernels_avx2();
+    case CpuSSE2:
+      return render_kernels_sse2();
+#endif
+    default:
+      return render_kernels_generic();
+  }
+}
+
+// initialized at startup, so the audio thread never does
+static const std::vector<float> sinc_table = make_sinc_table();
+static const RenderKernels render_kernels = select_render_kernels();
+
+uint32_t phase_increment(double freq, double sampleRate) {
+  if (!(freq > 0) || !(sampleRate > 0))
+    return 0;
+  double increment = freq / sampleRate;
+  increment -= std::floor(increment);
+  return uint32_t(uint64_t(std::llround(increment * 4294967296.0)));
+}
+
+uint32_t render_wavetable(const float *table1,
+                          const float *table2,
+                          float mix,
+                          unsigned log2size,
+                          uint32_t phase,
+                          uint32_t increment,
+                          float *out,
+                          unsigned count,
+                          InterpolationQuality quality) {
+  return render_wavetable_morph(
+    table1, table2, mix, 0, 0.0f, 0.0f,
+    log2size, phase, increment, out, count, quality);
+}
+
+uint32_t render_wavetable_morph(const float *table1,
+                                const float *table2,
+                                float mix,
+                                ptrdiff_t frameStride,
+                                float morph,
+                                float morphStep,
+                                unsigned log2size,
+                                uint32_t phase,
+                                uint32_t increment,
+                                float *out,
+                                unsigned count,
+                                InterpolationQuality quality) {
+  RenderArgs args;
+  args.table1 = table1;
+  args.table2 = table2;
+  args.mix = mix;
+  args.frameStride = frameStride;
+  args.morph = morph;
+  args.morphStep = morphStep;
+  args.log2size = log2size;
+  args.phase = phase;
+  args.increment = increment;
+  args.out = out;
+  args.count = count;
+  args.sinc = sinc_table.data();
+
+  bool crossfade = mix > 0 && table1 != table2;
+  bool morphing = frameStride != 0 && (morph != 0 || morphStep != 0);
+
+  switch (quality) {
+    case InterpLinear:
+      return render_kernels.linear[morphing][crossfade](args);
+    case InterpHermite:
+      return render_kernels.hermite[morphing][crossfade](args);
+    case InterpSinc:
+    default:
+      return render_kernels.sinc[morphing][crossfade](args);
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+enum InterpolationQuality {
+  InterpLinear,
+  InterpHermite,
+  InterpSinc,
+};
+
+#define INTERPOLATION_QUALITY_NAMES             \
+  {"Linear", "Hermite", "Sinc"}
+
+// samples replicated on either side of a table, for the widest kernel
+static const unsigned wavetable_guard = 4;
+
+// 32-bit fixed point phase increment, a period being 2^32
+uint32_t phase_increment(double freq, double sampleRate);
+
+// renders a block from a guard-padded table of 2^`log2size` samples
+//   `table1` and `table2` are crossfaded with weight `mix`. The phase wraps
+//   by overflow, and the one following the block is returned.
+uint32_t render_wavetable(const float *table1,
+                          const float *table2,
+                          float mix,
+                          unsigned log2size,
+                          uint32_t phase,
+                          uint32_t increment,
+                          float *out,
+                          unsigned count,
+                          InterpolationQuality quality);
+
+// as above, also morphing towards the frame `frameStride` samples further
+//   by a weight of `morph`, changing by `morphStep` every sample
+uint32_t render_wavetable_morph(const float *table1,
+                                const float *table2,
+                                float mix,
+                                ptrdiff_t frameStride,
+                                float morph,
+                                float morphStep,
+                                unsigned log2size,
+                                uint32_t phase,
+                                uint32_t increment,
+                                float *out,
+                                unsigned count,
+                                InterpolationQuality quality);
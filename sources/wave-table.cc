@@ -0,0 +1,122 @@
+#include "wave-table.h"
+#include "wave-render.h"
+#include "math-fft.h"
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cmath>
+
+static const unsigned min_log2size = 2;
+static const unsigned cache_line_floats = 64 / sizeof(float);
+
+MipmapWavetable::MipmapWavetable(const double *data, unsigned size, unsigned frameCount)
+  : sourceSize_(size), frameCount_((size > 0) ? frameCount : 0) {
+  if (frameCount_ == 0)
+    return;
+
+  unsigned log2size = min_log2size;
+  while ((1u << log2size) < size)
+    ++log2size;
+  log2size_ = log2size;
+  harmonics_ = size / 2;
+
+  levelCount_ = 1;
+  for (unsigned harmonics = harmonics_; harmonics > 1; harmonics /= 2)
+    ++levelCount_;
+
+  allocate();
+  for (unsigned frame = 0; frame < frameCount_; ++frame)
+    buildFrame(frame, &data[frame * size]);
+}
+
+MipmapWavetable::MipmapWavetable(const MipmapWavetable &other, unsigned frame, const double *data)
+  : sourceSize_(other.sourceSize_), log2size_(other.log2size_),
+    harmonics_(other.harmonics_), frameCount_(other.frameCount_),
+    levelCount_(other.levelCount_) {
+  if (frameCount_ == 0)
+    return;
+
+  allocate();
+  std::copy(other.base_, other.base_ + levelCount_ * frameCount_ * stride_, base_);
+  if (frame < frameCount_)
+    buildFrame(frame, data);
+}
+
+void MipmapWavetable::allocate() {
+  const unsigned guard = wavetable_guard;
+  const unsigned padded = guard + (1u << log2size_) + guard;
+  stride_ = (padded + cache_line_floats - 1) / cache_line_floats * cache_line_floats;
+
+  storage_.resize(levelCount_ * frameCount_ * stride_ + cache_line_floats);
+  uintptr_t addr = reinterpret_cast<uintptr_t>(storage_.data());
+  uintptr_t misalign = addr % (cache_line_floats * sizeof(float));
+  base_ = storage_.data() + (misalign ? (cache_line_floats - misalign / sizeof(float)) : 0);
+}
+
+float *MipmapWavetable::frameStart(unsigned level, unsigned frame) {
+  return base_ + (level * frameCount_ + frame) * stride_;
+}
+
+void MipmapWavetable::buildFrame(unsigned frame, const double *data) {
+  const unsigned size = sourceSize_;
+  const unsigned outsize = 1u << log2size_;
+  const unsigned guard = wavetable_guard;
+
+  std::vector<std::complex<double>> spectrum(size / 2 + 1);
+  real_fft(data, size, spectrum.data());
+
+  // rescale for the inverse at the new size; a Nyquist bin which is not
+  // also the Nyquist bin of the new size contributes twice, so halve it
+  for (std::complex<double> &bin : spectrum)
+    bin *= double(outsize) / size;
+  if (size % 2 == 0 && outsize != size)
+    spectrum[size / 2] *= 0.5;
+
+  std::vector<std::complex<double>> truncated(outsize / 2 + 1);
+  for (unsigned level = 0; level < levelCount_; ++level) {
+    unsigned harmonics = levelHarmonics(level);
+    std::fill(truncated.begin(), truncated.end(), 0.0);
+    std::copy(spectrum.begin(), spectrum.begin() + harmonics + 1, truncated.begin());
+
+    float *wave = frameStart(level, frame) + guard;
+    real_ifft(truncated.data(), outsize, wave);
+    for (unsigned i = 0; i < guard; ++i) {
+      wave[-1 - int(i)] = wave[outsize - 1 - i];
+      wave[outsize + i] = wave[i];
+    }
+  }
+}
+
+const float *MipmapWavetable::level(unsigned index, unsigned frame) const {
+  return base_ + (index * frameCount_ + frame) * stride_ + wavetable_guard;
+}
+
+unsigned MipmapWavetable::levelHarmonics(unsigned index) const {
+  return (index < 32) ? (harmonics_ >> index) : 0;
+}
+
+MipmapWavetable::Selection MipmapWavetable::select(double freq, double sampleRate) const {
+  Selection sel {0, 0.0f};
+
+  unsigned count = levelCount_;
+  if (count < 2 || freq <= 0 || sampleRate <= 0)
+    return sel;
+
+  // at fractional octave `octave`, levels `ceil(octave)` and beyond are
+  // free of aliasing; fading from the first of these towards the next one
+  // keeps the timbre continuous as the frequency changes
+  double octave = std::log2(freq * levelHarmonics(0) / (0.5 * sampleRate));
+  if (octave <= -1.0)
+    return sel;
+
+  double whole = std::floor(octave);
+  int index = int(whole) + 1;
+  if (index >= int(count) - 1) {
+    sel.level = count - 1;
+    return sel;
+  }
+
+  sel.level = index;
+  sel.mix = octave - whole;
+  return sel;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// band-limited copies of single-cycle waves, one per octave
+//   A table holds one or more frames of the same size, to morph between.
+//   Level 0 has all the harmonics, and each next level keeps half of them.
+//   Levels are resynthesized at a power-of-2 size, and padded on either side
+//   with `wavetable_guard` samples of the wrapped wave. The frames of a
+//   level are contiguous, each of them starting on a cache line.
+class MipmapWavetable {
+ public:
+  // `frameCount` consecutive frames of `size` samples
+  MipmapWavetable(const double *data, unsigned size, unsigned frameCount = 1);
+  // a copy of `other` with one of its frames replaced
+  MipmapWavetable(const MipmapWavetable &other, unsigned frame, const double *data);
+
+  MipmapWavetable(const MipmapWavetable &) = delete;
+  MipmapWavetable &operator=(const MipmapWavetable &) = delete;
+
+  unsigned size() const { return 1u << log2size_; }
+  unsigned log2Size() const { return log2size_; }
+  unsigned sourceSize() const { return sourceSize_; }
+  unsigned frameCount() const { return frameCount_; }
+  unsigned levelCount() const { return levelCount_; }
+  const float *level(unsigned index, unsigned frame = 0) const;
+  unsigned levelHarmonics(unsigned index) const;
+
+  // distance from a frame of a level to the next frame
+  ptrdiff_t frameStride() const { return stride_; }
+
+  // the pair of levels to crossfade for playback free of aliasing
+  struct Selection {
+    unsigned level;
+    float mix;  // weight of the next level
+  };
+  Selection select(double freq, double sampleRate) const;
+
+ private:
+  void allocate();
+  void buildFrame(unsigned frame, const double *data);
+  float *frameStart(unsigned level, unsigned frame);
+
+  unsigned sourceSize_ {};
+  unsigned log2size_ {};
+  unsigned harmonics_ {};
+  unsigned frameCount_ {};
+  unsigned levelCount_ {};
+  unsigned stride_ {};
+  std::vector<float> storage_;
+  float *base_ {};  // into the storage, aligned to a cache line
+};